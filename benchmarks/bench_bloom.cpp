@@ -0,0 +1,49 @@
+/*
+ * Path-filtered history walk, with and without the changed-path index.
+ *
+ * Usage: bench_bloom <repository> <path> [iterations]
+ */
+#include "benchmark.h"
+#include "standard-release/git/repository.h"
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+using namespace StandardRelease;
+
+static size_t walk(const std::string &dir, const std::string &path, bool indexed)
+{
+    GitRepository repo;
+    repo.open(dir);
+    repo.setPathFilter(path);
+    repo.setPathIndex(indexed);
+    repo.parse("0.0.0");
+    return repo.commits().size();
+}
+
+int main(int argc, const char **argv)
+{
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <repository> <path> [iterations]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const std::string dir = argv[1];
+    const std::string path = argv[2];
+    const size_t iterations = argc > 3 ? std::stoul(argv[3]) : 5;
+    const auto indexFile = std::filesystem::path(dir) / ".git/standard-release/changed-paths";
+    size_t unindexed = 0;
+    size_t indexed = 0;
+
+    std::error_code code;
+    std::filesystem::remove(indexFile, code);
+
+    Benchmark::run("walk (no index)", iterations, [&] { unindexed = walk(dir, path, false); });
+    std::filesystem::remove(indexFile, code);
+    Benchmark::once("walk (building index)", [&] { indexed = walk(dir, path, true); });
+    Benchmark::run("walk (index)", iterations, [&] { indexed = walk(dir, path, true); });
+
+    std::cout << unindexed << " commits without the index, " << indexed << " with it" << std::endl;
+
+    return unindexed == indexed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,93 @@
+/*
+ * Version parsing, conventional commit parsing and changelog emission on synthetic input.
+ *
+ * Usage: bench_parse [commits] [iterations]
+ *
+ * Set BENCHMARK_PERF=1 to add cycles, instructions, IPC, branch and cache misses per iteration.
+ */
+#include "benchmark.h"
+#include "standard-release/changelog/changelog.h"
+#include "standard-release/commits/conventional.h"
+#include "standard-release/git/repository.h"
+#include "standard-release/semver/semver.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace StandardRelease;
+
+class BenchChangelog : public Changelog
+{
+public:
+    size_t length() const
+    {
+        return content().length();
+    }
+};
+
+// A mix of headers in the shapes seen in real histories.
+static GitRepository::Commits makeCommits(size_t count)
+{
+    static const char *headers[] = {
+        "feat(core): add a configurable walk mode",
+        "fix: handle trailing commas in the csv header",
+        "perf(git): decode commits in batches",
+        "docs: describe the changed-path index",
+        "chore(deps): bump libgit2",
+        "refactor!: drop the legacy config loader",
+        "Merge pull request #42 from feature/batch",
+        "test(changelog): cover empty sections",
+    };
+    const size_t headerCount = sizeof(headers) / sizeof(headers[0]);
+
+    GitRepository::Commits commits;
+    for (size_t i = 0; i < count; i++) {
+        const std::string hash = std::to_string(1000000 + i);
+        const char *body = i % 5 == 0 ? "BREAKING CHANGE: the old loader is gone" : "";
+        commits.push_back(GitRepository::Commit(headers[i % headerCount], body, hash.c_str()));
+    }
+    return commits;
+}
+
+int main(int argc, const char **argv)
+{
+    const size_t commitCount = argc > 1 ? std::stoul(argv[1]) : 1000;
+    const size_t iterations = argc > 2 ? std::stoul(argv[2]) : 20;
+
+    const std::vector<std::string> versions { "1.2.3", "v10.20.30", "0.0.1", "2.0.0-rc.1" };
+    size_t parsed = 0;
+    Benchmark::run("SemVer::parse (x1000)", iterations, [&] {
+        SemVer version;
+        for (size_t i = 0; i < 1000; i++) {
+            parsed += version.parse(versions[i % versions.size()]) ? 1 : 0;
+        }
+    });
+
+    const auto commits = makeCommits(commitCount);
+    Benchmark::run("ConventionalCommits::parseCommits (" + std::to_string(commitCount) + ")",
+                   iterations, [&] {
+                       ConventionalCommits conventional;
+                       conventional.setVersion(SemVer(1, 0, 0));
+                       conventional.parseCommits(commits);
+                       conventional.bump();
+                   });
+
+    ConventionalCommits conventional;
+    conventional.setVersion(SemVer(1, 0, 0));
+    conventional.parseCommits(commits);
+    conventional.bump();
+
+    size_t length = 0;
+    Benchmark::run("Changelog::generate (" + std::to_string(commitCount) + ")", iterations, [&] {
+        BenchChangelog changelog;
+        changelog.read();
+        changelog.generate(conventional.version(), SemVer(1, 0, 0), conventional.table(),
+                           "https://github.com/Symbitic/standard-release");
+        length = changelog.length();
+    });
+
+    std::cout << parsed << " versions parsed, " << conventional.commits().size()
+              << " conventional commits, " << length << " bytes of changelog" << std::endl;
+
+    return EXIT_SUCCESS;
+}
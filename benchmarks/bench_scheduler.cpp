@@ -0,0 +1,52 @@
+/*
+ * TaskScheduler scaling from 1 to N workers on a CPU-bound workload.
+ *
+ * Usage: bench_scheduler [max workers] [tasks]
+ */
+#include "benchmark.h"
+#include "standard-release/tasks/scheduler.h"
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+using namespace StandardRelease;
+
+// Roughly a few microseconds of integer work that the compiler cannot remove.
+static uint64_t spin(uint64_t seed)
+{
+    uint64_t x = seed | 1;
+    for (int i = 0; i < 2000; i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+    }
+    return x;
+}
+
+int main(int argc, const char **argv)
+{
+    const size_t maxWorkers = argc > 1 ? std::stoul(argv[1]) : TaskScheduler::defaultWorkerCount();
+    const size_t tasks = argc > 2 ? std::stoul(argv[2]) : 100000;
+    double baseline = 0;
+
+    for (size_t workers = 1; workers <= maxWorkers; workers++) {
+        TaskScheduler scheduler(workers);
+        std::atomic<uint64_t> sink { 0 };
+
+        const auto result = Benchmark::run(std::to_string(workers) + " workers", 3, [&] {
+            TaskGroup group(scheduler);
+            for (size_t i = 0; i < tasks; i++) {
+                group.run([&sink, i] { sink.fetch_xor(spin(i), std::memory_order_relaxed); });
+            }
+            group.wait();
+        });
+
+        if (workers == 1) {
+            baseline = result.totalMs;
+        }
+        std::cout << "    speedup " << baseline / result.totalMs << "x" << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
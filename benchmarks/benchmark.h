@@ -0,0 +1,114 @@
+/**
+ * @file benchmarks/benchmark.h
+ * @brief Minimal timing harness shared by the benchmarks.
+ */
+#pragma once
+
+#include "perf.h"
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+namespace Benchmark {
+
+/**
+ * @brief Timing of a single benchmark.
+ */
+struct Result
+{
+    std::string name;
+    size_t iterations;
+    double totalMs;
+    PerfCounters::Values perf;
+
+    /** Average time per iteration, in microseconds. */
+    double perIterationUs() const
+    {
+        return iterations == 0 ? 0 : totalMs * 1000 / iterations;
+    }
+};
+
+/**
+ * @brief Counters shared by all benchmarks in the process.
+ * @details Prints why hardware counters are off the first time they were requested but could
+ * not be opened.
+ */
+inline PerfCounters &perfCounters()
+{
+    static PerfCounters counters;
+    static bool reported = false;
+
+    if (!reported && !counters.available() && std::getenv("BENCHMARK_PERF") != nullptr) {
+        std::printf("perf counters unavailable (%s); timing only\n", counters.reason().c_str());
+    }
+    reported = true;
+    return counters;
+}
+
+/** Print a result as one aligned line, plus per-iteration counters when available. */
+inline void print(const Result &result)
+{
+    std::printf("%-40s %10zu iter %12.3f ms %12.3f us/iter\n", result.name.c_str(),
+                result.iterations, result.totalMs, result.perIterationUs());
+
+    const auto &perf = result.perf;
+    if (result.iterations == 0 || !(perf.has(PerfCounters::Cycles)
+                                    || perf.has(PerfCounters::Instructions))) {
+        return;
+    }
+
+    const auto perIteration = [&](PerfCounters::Event event) {
+        return perf.has(event) ? static_cast<double>(perf.counts[event]) / result.iterations : -1;
+    };
+    std::printf("%-40s %10.0f cyc %10.0f ins %8.2f IPC %8.1f br-miss %8.1f cache-miss\n", "",
+                perIteration(PerfCounters::Cycles), perIteration(PerfCounters::Instructions),
+                perf.ipc(), perIteration(PerfCounters::BranchMisses),
+                perIteration(PerfCounters::CacheMisses));
+}
+
+/**
+ * @brief Time a function (and count hardware events, see perf.h).
+ * @param[in] name Name to print.
+ * @param[in] iterations Number of timed calls (after one untimed warm-up call).
+ * @param[in] fn Function to benchmark.
+ */
+template<typename Fn>
+Result run(const std::string &name, size_t iterations, Fn &&fn)
+{
+    PerfCounters &counters = perfCounters();
+    fn();
+
+    counters.start();
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        fn();
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    const auto perf = counters.stop();
+
+    Result result { name, iterations, std::chrono::duration<double, std::milli>(elapsed).count(),
+                    perf };
+    print(result);
+    return result;
+}
+
+/**
+ * @brief Time a single call, without a warm-up (e.g. building a cache from scratch).
+ */
+template<typename Fn>
+Result once(const std::string &name, Fn &&fn)
+{
+    PerfCounters &counters = perfCounters();
+
+    counters.start();
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    const auto perf = counters.stop();
+
+    Result result { name, 1, std::chrono::duration<double, std::milli>(elapsed).count(), perf };
+    print(result);
+    return result;
+}
+
+}
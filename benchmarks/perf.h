@@ -0,0 +1,171 @@
+/**
+ * @file benchmarks/perf.h
+ * @brief Hardware performance counters for the benchmarks (Linux `perf_event_open`).
+ *
+ * Counting is opt-in (`BENCHMARK_PERF=1`) and degrades to timing only when the kernel refuses
+ * (containers, `perf_event_paranoid`, VMs without a PMU) or on other platforms. Each counter is
+ * opened separately, so a machine that lacks e.g. cache-miss events still reports the rest.
+ * Only the calling thread is counted.
+ */
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#ifdef __linux__
+#    include <linux/perf_event.h>
+#    include <sys/ioctl.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#endif
+
+namespace Benchmark {
+
+/**
+ * @brief Cycles, instructions, branch misses and cache misses around a measured region.
+ */
+class PerfCounters
+{
+public:
+    enum Event
+    {
+        Cycles,
+        Instructions,
+        BranchMisses,
+        CacheMisses,
+        EventCount,
+    };
+
+    /** Counter values of one measurement; -1 if the event is unavailable. */
+    struct Values
+    {
+        int64_t counts[EventCount] = { -1, -1, -1, -1 };
+
+        bool has(Event event) const
+        {
+            return counts[event] >= 0;
+        }
+
+        /** Instructions per cycle, or 0 if either is unavailable. */
+        double ipc() const
+        {
+            return has(Cycles) && has(Instructions) && counts[Cycles] > 0
+                    ? static_cast<double>(counts[Instructions]) / counts[Cycles]
+                    : 0;
+        }
+    };
+
+    /** Open the counters if `BENCHMARK_PERF` is set (see available()). */
+    PerfCounters()
+    {
+        const char *env = std::getenv("BENCHMARK_PERF");
+        if (env == nullptr || std::strcmp(env, "0") == 0) {
+            m_reason = "set BENCHMARK_PERF=1 to enable";
+            return;
+        }
+
+#ifdef __linux__
+        static const uint64_t configs[EventCount] = {
+            PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_BRANCH_MISSES,
+            PERF_COUNT_HW_CACHE_MISSES,
+        };
+
+        for (int i = 0; i < EventCount; i++) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[i];
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            m_fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+            if (m_fds[i] < 0 && m_reason.empty()) {
+                m_reason = std::strerror(errno);
+            }
+        }
+
+        if (m_fds[Cycles] >= 0 || m_fds[Instructions] >= 0) {
+            m_reason.clear();
+        }
+#else
+        m_reason = "perf_event_open is only available on Linux";
+#endif
+    }
+
+    ~PerfCounters()
+    {
+#ifdef __linux__
+        for (const int fd : m_fds) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    /** Can at least cycles or instructions be counted? */
+    bool available() const
+    {
+        return m_reason.empty();
+    }
+
+    /** Why counting is unavailable. */
+    const std::string &reason() const
+    {
+        return m_reason;
+    }
+
+    /** Reset and start every open counter. */
+    void start()
+    {
+#ifdef __linux__
+        for (const int fd : m_fds) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    /** Stop the counters and read them, scaled if the kernel multiplexed them. */
+    Values stop()
+    {
+        Values values;
+#ifdef __linux__
+        for (int i = 0; i < EventCount; i++) {
+            if (m_fds[i] >= 0) {
+                ioctl(m_fds[i], PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+        for (int i = 0; i < EventCount; i++) {
+            uint64_t data[3] = { 0, 0, 0 }; // value, time enabled, time running
+            if (m_fds[i] < 0 || read(m_fds[i], data, sizeof(data)) != sizeof(data)) {
+                continue;
+            }
+            values.counts[i] = data[2] == 0
+                    ? 0
+                    : static_cast<int64_t>(static_cast<double>(data[0]) * data[1] / data[2]);
+        }
+#endif
+        return values;
+    }
+
+private:
+    int m_fds[EventCount] = { -1, -1, -1, -1 };
+    std::string m_reason;
+};
+
+}
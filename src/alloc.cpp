@@ -0,0 +1,127 @@
+// Counting replacements for the global allocation functions, used by `--stats`.
+// They only count while Stats is enabled; otherwise they cost one relaxed load.
+// ENABLE_ALLOC_PROFILER builds also charge every call to the thread's AllocPhase.
+#include "standard-release/stats/allocprofiler.h"
+#include "standard-release/stats/stats.h"
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+using namespace StandardRelease;
+
+static void count(std::size_t size)
+{
+    if (Stats::isEnabled()) {
+        Stats::add(Stats::Allocations);
+        Stats::add(Stats::AllocatedBytes, size);
+    }
+#ifdef STANDARDRELEASE_ALLOC_PROFILER
+    AllocProfiler::recordAllocation(size);
+#endif
+}
+
+static void release(void *ptr)
+{
+#ifdef STANDARDRELEASE_ALLOC_PROFILER
+    if (ptr != nullptr) {
+        AllocProfiler::recordFree();
+    }
+#endif
+    std::free(ptr);
+}
+
+static void *allocate(std::size_t size)
+{
+    count(size);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+static void *allocateAligned(std::size_t size, std::align_val_t alignment)
+{
+    void *ptr = nullptr;
+    const std::size_t align = std::max(static_cast<std::size_t>(alignment), sizeof(void *));
+
+    count(size);
+    if (posix_memalign(&ptr, align, size == 0 ? 1 : size) != 0) {
+        return nullptr;
+    }
+    return ptr;
+}
+
+void *operator new(std::size_t size)
+{
+    void *ptr = allocate(size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    return allocate(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    return allocate(size);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    void *ptr = allocateAligned(size, alignment);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    release(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    release(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    release(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept
+{
+    release(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept
+{
+    release(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t) noexcept
+{
+    release(ptr);
+}
+
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept
+{
+    release(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept
+{
+    release(ptr);
+}
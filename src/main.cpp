@@ -1,20 +1,65 @@
+#include "standard-release/batch/batch.h"
 #include "standard-release/changelog/changelog.h"
 #include "standard-release/commits/conventional.h"
 #include "standard-release/config/yaml.h"
+#include "standard-release/daemon/daemon.h"
 #include "standard-release/errors/error.h"
 #include "standard-release/errors/errors.h"
 #include "standard-release/git/hooks.h"
 #include "standard-release/git/repository.h"
+#include "standard-release/log/async.h"
 #include "standard-release/semver/semver.h"
 #include "standard-release/sources/json.h"
 #include "standard-release/sources/text.h"
 #include "standard-release/standard-release.h"
+#include "standard-release/stats/allocprofiler.h"
+#include "standard-release/stats/stats.h"
+#include "standard-release/trace/trace.h"
+#include <csignal>
+#include <cstdlib>
 #include <cstring>
+#include <fstream>
 #include <initializer_list>
 #include <iostream>
+#include <vector>
 
 using namespace StandardRelease;
 
+// Static so queued messages are still written when a mode calls exit().
+static AsyncLogger logger;
+
+// Chrome trace output (--trace), empty if disabled.
+static std::string traceFile;
+
+// Run statistics (--stats, --stats-json).
+static bool printStats = false;
+static std::string statsFile;
+
+static void saveStats()
+{
+    if (printStats) {
+        std::cerr << Stats::report();
+        if (AllocProfiler::isCompiledIn()) {
+            std::cerr << std::endl << AllocProfiler::report(Stats::value(Stats::CommitsWalked));
+        }
+    }
+    if (!statsFile.empty() && !Stats::save(statsFile)) {
+        std::cerr << "Error: could not write statistics to " << statsFile << std::endl;
+    }
+}
+
+static void saveTrace()
+{
+    if (traceFile.empty()) {
+        return;
+    }
+
+    Tracer::global().stop();
+    if (!Tracer::global().save(traceFile)) {
+        std::cerr << "Error: could not write trace to " << traceFile << std::endl;
+    }
+}
+
 template<typename... Args>
 static inline bool hasoption(std::string &arg, Args &&...args)
 {
@@ -59,26 +104,157 @@ static void release(Main &program)
         program.release();
     } catch (Exception e) {
         std::cerr << "Error: " << e.what() << std::endl;
+        saveStats();
+        saveTrace();
+        exit(EXIT_FAILURE);
+    }
+    saveStats();
+    saveTrace();
+    exit(EXIT_SUCCESS);
+}
+
+// Compute the release and write it to a plan file.
+static void planRelease(Main &program, const std::string &planFile)
+{
+    try {
+        program.plan(planFile);
+    } catch (Exception e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        saveStats();
+        saveTrace();
         exit(EXIT_FAILURE);
     }
+    saveStats();
+    saveTrace();
     exit(EXIT_SUCCESS);
 }
 
+// Make the release recorded in a plan file.
+static void applyPlan(Main &program, const std::string &planFile)
+{
+    try {
+        program.apply(planFile);
+    } catch (Exception e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        saveStats();
+        saveTrace();
+        exit(EXIT_FAILURE);
+    }
+    saveStats();
+    saveTrace();
+    exit(EXIT_SUCCESS);
+}
+
+// Release every repository in a list and report each result.
+static void batch(const std::vector<std::string> &repoDirs, const std::string &configFile,
+                  size_t jobs, const std::string &reportFile)
+{
+    BatchRelease releases;
+    for (const auto &repoDir : repoDirs) {
+        releases.addRepository(repoDir);
+    }
+    releases.setConfigFile(configFile);
+    releases.setJobs(jobs);
+
+    const auto results = releases.run();
+
+    bool ok = true;
+    for (const auto &result : results) {
+        if (result.exitCode == EXIT_SUCCESS) {
+            std::cout << "ok    " << result.dirName << " " << result.version << std::endl;
+        } else {
+            std::cout << "fail  " << result.dirName << ": " << result.message << std::endl;
+            ok = false;
+        }
+    }
+
+    if (!reportFile.empty()) {
+        std::ofstream out(reportFile, std::ios::binary | std::ios::trunc);
+        out << BatchRelease::report(results);
+        if (!out) {
+            std::cerr << "Error: could not write report to " << reportFile << std::endl;
+            ok = false;
+        }
+    }
+
+    saveStats();
+    saveTrace();
+    exit(ok ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+#ifdef STANDARDRELEASE_DAEMON
+static Daemon *runningDaemon = nullptr;
+
+static void stopDaemon(int)
+{
+    runningDaemon->stop();
+}
+
+// Keep the next release of every repository precomputed and answer queries on a socket.
+static void daemon(const std::vector<std::string> &repoDirs, const std::string &configFile,
+                   const std::string &socketFile)
+{
+    Daemon daemon;
+
+    for (const auto &repoDir : repoDirs) {
+        if (!daemon.addRepository(repoDir, repoDirs.size() == 1 ? configFile : "")) {
+            std::cerr << "Error: " << repoDir << ": " << daemon.error() << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    const auto socketPath = socketFile.empty()
+            ? std::filesystem::path(repoDirs.front()) / ".git" / "standard-release" / "daemon.sock"
+            : std::filesystem::path(socketFile);
+    if (!daemon.listen(socketPath)) {
+        std::cerr << "Error: " << daemon.error() << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    runningDaemon = &daemon;
+    std::signal(SIGINT, stopDaemon);
+    std::signal(SIGTERM, stopDaemon);
+
+    const bool ok = daemon.run();
+    runningDaemon = nullptr;
+    if (!ok) {
+        std::cerr << "Error: " << daemon.error() << std::endl;
+    }
+
+    saveStats();
+    saveTrace();
+    exit(ok ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+#endif
+
 static void help(int argc, const char **argv)
 {
     std::cout << "Usage: " << argv[0] << " [options] <mode>" << std::endl
               << std::endl
               << "Options:" << std::endl
               << "  -c, --config <file>  Configuration file." << std::endl
-              << "  -r, --repo <dir>     Git repository." << std::endl
+              << "  -r, --repo <dir>     Git repository (repeat for several in daemon mode)."
+              << std::endl
               << "  -i, --init           Enable init mode." << std::endl
               << "  -l, --lint           Enable lint mode." << std::endl
+              << "  -v, --verbose        Print debug messages." << std::endl
+              << "  --trace <file>       Write a Chrome trace of the release." << std::endl
+              << "  --stats              Print run statistics." << std::endl
+              << "  --stats-json <file>  Write run statistics as JSON." << std::endl
+              << "  --socket <file>      Socket for daemon mode." << std::endl
+              << "  --batch <file>       Release every repository listed in a file." << std::endl
+              << "  --jobs <n>           Repositories released at a time in batch mode."
+              << std::endl
+              << "  --report <file>      Write batch results as JSON." << std::endl
               << "  -h, --help           Print usage." << std::endl
               << std::endl
               << "Modes:" << std::endl
               << "  init                 Install git hooks." << std::endl
               << "  lint                 Lint a git message." << std::endl
-              << "  release (default)    Create a new release." << std::endl;
+              << "  release (default)    Create a new release." << std::endl
+              << "  plan <file>          Write the next release to a plan file." << std::endl
+              << "  apply <file>         Create the release in a plan file." << std::endl
+              << "  daemon               Keep the next release precomputed." << std::endl;
 
     exit(EXIT_SUCCESS);
 }
@@ -93,15 +269,29 @@ int main(int argc, const char **argv)
         Init,
         Lint,
         Help,
+        DaemonMode,
+        Plan,
+        Apply,
+        Batch,
     };
     Mode mode = Default;
     int modeCount = 0;
     std::string configFile;
     std::string repoDir;
+    std::vector<std::string> repoDirs;
+    std::string socketFile;
     std::string lintMsg;
+    std::string planFile;
+    std::string batchFile;
+    std::string reportFile;
+    size_t jobs = 0;
     Main program;
     std::error_code code;
 
+    logger.setLevel(ILogger::Warning);
+    logger.open();
+    ILogger::setInstance(&logger);
+
     repoDir = std::filesystem::current_path(code);
 
     for (int i = 1; i < argc; i++) {
@@ -121,10 +311,75 @@ int main(int argc, const char **argv)
             }
             lintMsg = argv[i + 1];
             i++;
+        } else if (hasoption(arg, "plan", "apply")) {
+            mode = arg == "plan" ? Mode::Plan : Mode::Apply;
+            modeCount++;
+            if (i == argc - 1 || argv[i + 1][0] == '-') {
+                std::cerr << "Missing file for '" << arg << "'\n";
+                exit(EXIT_FAILURE);
+            }
+            planFile = argv[i + 1];
+            i++;
+        } else if (hasoption(arg, "--batch")) {
+            mode = Mode::Batch;
+            modeCount++;
+            if (i == argc - 1 || argv[i + 1][0] == '-') {
+                std::cerr << "Missing file for '--batch'\n";
+                exit(EXIT_FAILURE);
+            }
+            batchFile = argv[i + 1];
+            i++;
+        } else if (hasoption(arg, "--jobs")) {
+            const char *value = i == argc - 1 ? "" : argv[i + 1];
+            char *end = nullptr;
+            jobs = std::strtoul(value, &end, 10);
+            if (jobs == 0 || *end != '\0') {
+                std::cerr << "Expected a positive number for '--jobs'\n";
+                exit(EXIT_FAILURE);
+            }
+            i++;
+        } else if (hasoption(arg, "--report")) {
+            if (i == argc - 1 || argv[i + 1][0] == '-') {
+                std::cerr << "Missing file for '--report'\n";
+                exit(EXIT_FAILURE);
+            }
+            reportFile = argv[i + 1];
+            i++;
+        } else if (hasoption(arg, "daemon")) {
+            mode = Mode::DaemonMode;
+            modeCount++;
+        } else if (hasoption(arg, "--socket")) {
+            if (i == argc - 1 || argv[i + 1][0] == '-') {
+                std::cerr << "Missing file for '--socket'\n";
+                exit(EXIT_FAILURE);
+            }
+            socketFile = argv[i + 1];
+            i++;
         } else if (hasoption(arg, "release")) {
             mode = Mode::Default;
             modeCount++;
             continue;
+        } else if (hasoption(arg, "-v", "--verbose")) {
+            logger.setLevel(ILogger::Debug);
+        } else if (hasoption(arg, "--trace")) {
+            if (i == argc - 1 || argv[i + 1][0] == '-') {
+                std::cerr << "Missing file for '--trace'\n";
+                exit(EXIT_FAILURE);
+            }
+            traceFile = argv[i + 1];
+            Tracer::global().start();
+            i++;
+        } else if (hasoption(arg, "--stats")) {
+            printStats = true;
+            Stats::start();
+        } else if (hasoption(arg, "--stats-json")) {
+            if (i == argc - 1 || argv[i + 1][0] == '-') {
+                std::cerr << "Missing file for '--stats-json'\n";
+                exit(EXIT_FAILURE);
+            }
+            statsFile = argv[i + 1];
+            Stats::start();
+            i++;
         } else if (hasoption(arg, "-c", "--config")) {
             if (i == argc - 1 || argv[i + 1][0] == '-') {
                 std::cerr << "Missing file for '--config'\n";
@@ -138,6 +393,7 @@ int main(int argc, const char **argv)
                 exit(EXIT_FAILURE);
             }
             repoDir = argv[i + 1];
+            repoDirs.push_back(repoDir);
             i++;
         } else {
             std::cerr << "Unrecognized option '" << arg << "'\n";
@@ -150,6 +406,32 @@ int main(int argc, const char **argv)
         exit(EXIT_FAILURE);
     }
 
+    if (mode == Mode::Batch) {
+        if (!BatchRelease::readList(batchFile, repoDirs)) {
+            std::cerr << "Error: could not read " << batchFile << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        batch(repoDirs, configFile, jobs, reportFile);
+    }
+
+    if (mode == Mode::DaemonMode) {
+#ifdef STANDARDRELEASE_DAEMON
+        if (repoDirs.empty()) {
+            repoDirs.push_back(repoDir);
+        }
+        for (const auto &dir : repoDirs) {
+            if (!GitRepository::isRepo(dir)) {
+                std::cerr << "Error: " << dir << " is not a git repository" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+        }
+        daemon(repoDirs, configFile, socketFile);
+#else
+        std::cerr << "Error: daemon mode is only available on Linux" << std::endl;
+        exit(EXIT_FAILURE);
+#endif
+    }
+
     bool repoFound = GitRepository::isRepo(repoDir);
     if (!repoFound) {
         std::cerr << "Error: " << repoDir << " is not a git repository" << std::endl;
@@ -159,8 +441,11 @@ int main(int argc, const char **argv)
     program.setDirname(repoDir);
 
     try {
-        // Do not read config file in lint or help mode.
-        if (mode != Mode::Lint && mode != Mode::Help) {
+        // Do not read config file in lint or help mode. Release mode reads it in parallel
+        // with its other phases.
+        if (mode == Mode::Default || mode == Mode::Plan || mode == Mode::Apply) {
+            program.setConfigFile(configFile);
+        } else if (mode != Mode::Lint && mode != Mode::Help) {
             program.readConfigFile(configFile);
         }
     } catch (Exception e) {
@@ -178,6 +463,12 @@ int main(int argc, const char **argv)
         case Mode::Lint:
             lint(program, lintMsg);
             break;
+        case Mode::Plan:
+            planRelease(program, planFile);
+            break;
+        case Mode::Apply:
+            applyPlan(program, planFile);
+            break;
         case Mode::Default:
         default:
             release(program);
@@ -0,0 +1,193 @@
+#include "standard-release/batch/batch.h"
+#include "git2/global.h"
+#include "standard-release/config/yaml.h"
+#include "standard-release/errors/error.h"
+#include "standard-release/git/repository.h"
+#include "standard-release/log/ilog.h"
+#include "standard-release/standard-release.h"
+#include "standard-release/tasks/scheduler.h"
+#include "standard-release/trace/trace.h"
+#include "standard-release/util/json.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+using namespace StandardRelease;
+
+struct StandardRelease::BatchReleasePrivate
+{
+    std::vector<std::string> dirNames;
+    size_t jobs = 0;
+    std::string configFile;
+
+    BatchRelease::Result release(const std::string &dirName, IConfig *config,
+                                 const std::string &configError);
+};
+
+using Result = BatchRelease::Result;
+
+Result BatchReleasePrivate::release(const std::string &dirName, IConfig *config,
+                                    const std::string &configError)
+{
+    TraceSpan span("batch-release", "batch");
+
+    const auto start = std::chrono::steady_clock::now();
+    Result result { dirName, EXIT_FAILURE, "", "", 0 };
+
+    if (!configError.empty()) {
+        result.message = configError;
+    } else if (!GitRepository::isRepo(dirName)) {
+        result.message = dirName + " is not a git repository";
+    } else {
+        try {
+            Main program(dirName);
+            if (config != nullptr) {
+                program.setConfig(config);
+            }
+            program.release();
+            result.version = program.nextVersion().str();
+            result.exitCode = EXIT_SUCCESS;
+        } catch (const std::exception &e) {
+            result.message = e.what();
+        }
+    }
+
+    const std::chrono::duration<double, std::milli> elapsed
+            = std::chrono::steady_clock::now() - start;
+    result.wallMs = elapsed.count();
+
+    if (result.exitCode == EXIT_SUCCESS) {
+        srInfo(lcRelease()) << dirName << ": released " << result.version;
+    } else {
+        srWarning(lcRelease()) << dirName << ": " << result.message;
+    }
+
+    return result;
+}
+
+BatchRelease::BatchRelease()
+    : d(new BatchReleasePrivate)
+{
+}
+
+BatchRelease::~BatchRelease()
+{
+    delete d;
+}
+
+bool BatchRelease::readList(const std::filesystem::path &fileName,
+                            std::vector<std::string> &dirNames)
+{
+    std::ifstream in(fileName);
+    std::string line;
+
+    if (!in) {
+        return false;
+    }
+
+    while (std::getline(in, line)) {
+        const auto begin = line.find_first_not_of(" \t\r");
+        if (begin == std::string::npos || line[begin] == '#') {
+            continue;
+        }
+        const auto end = line.find_last_not_of(" \t\r");
+        dirNames.push_back(line.substr(begin, end - begin + 1));
+    }
+
+    return true;
+}
+
+void BatchRelease::addRepository(const std::string &dirName)
+{
+    d->dirNames.push_back(dirName);
+}
+
+std::vector<std::string> BatchRelease::repositories() const
+{
+    return d->dirNames;
+}
+
+void BatchRelease::setJobs(size_t jobs)
+{
+    d->jobs = jobs;
+}
+
+size_t BatchRelease::jobs() const
+{
+    return d->jobs == 0 ? TaskScheduler::global().workerCount() : d->jobs;
+}
+
+void BatchRelease::setConfigFile(const std::string &fileName)
+{
+    d->configFile = fileName;
+}
+
+std::vector<Result> BatchRelease::run()
+{
+    TraceSpan span("batch", "batch");
+
+    const size_t count = d->dirNames.size();
+    std::vector<Result> results(count);
+    std::unique_ptr<YamlConfig> config;
+    std::string configError;
+
+    // Held for the whole batch so libgit2 is not torn down and set up again between
+    // repositories.
+    git_libgit2_init();
+
+    if (!d->configFile.empty()) {
+        config = std::make_unique<YamlConfig>(d->configFile);
+        try {
+            config->parse();
+        } catch (const std::exception &e) {
+            configError = e.what();
+        }
+    }
+
+    // Each lane releases one repository at a time; the releases' own tasks share the pool.
+    std::atomic<size_t> next { 0 };
+    const size_t lanes = std::min(jobs(), count);
+    TaskGroup group;
+    for (size_t lane = 0; lane < lanes; lane++) {
+        group.run([this, &next, &results, &config, &configError, count] {
+            for (size_t i = next++; i < count; i = next++) {
+                results[i] = d->release(d->dirNames[i], config.get(), configError);
+            }
+        });
+    }
+    group.wait();
+
+    git_libgit2_shutdown();
+
+    return results;
+}
+
+std::string BatchRelease::report(const std::vector<Result> &results)
+{
+    std::ostringstream out;
+    size_t failed = 0;
+
+    out << "{\n  \"repositories\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        const auto &result = results[i];
+        if (result.exitCode != EXIT_SUCCESS) {
+            failed++;
+        }
+
+        out << (i == 0 ? "\n" : ",\n") << "    {\"dir\": ";
+        appendJsonString(out, result.dirName);
+        out << ", \"exit_code\": " << result.exitCode << ", \"version\": ";
+        appendJsonString(out, result.version);
+        out << ", \"error\": ";
+        appendJsonString(out, result.message);
+        out << ", \"wall_ms\": " << result.wallMs << "}";
+    }
+    out << "\n  ],\n  \"succeeded\": " << results.size() - failed << ",\n  \"failed\": " << failed
+        << "\n}\n";
+
+    return out.str();
+}
@@ -0,0 +1,84 @@
+/**
+ * @file "standard-release/batch/batch.h"
+ * @brief Release many repositories in one process.
+ */
+#pragma once
+
+#include "standard-release/global/global.h"
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace StandardRelease {
+
+class BatchReleasePrivate;
+
+/**
+ * @brief Releases a list of repositories concurrently.
+ * @details libgit2 is initialized once for the whole batch and every release runs on the shared
+ * TaskScheduler, so the phases of different repositories interleave on the same workers. At most
+ * jobs() repositories are released at a time. A failed release does not stop the others.
+ */
+class STANDARDRELEASE_EXPORT BatchRelease
+{
+public:
+    /** Outcome of one repository. */
+    struct Result
+    {
+        std::string dirName;
+        /** `EXIT_SUCCESS` or `EXIT_FAILURE`, as the single-repository release would exit. */
+        int exitCode;
+        /** Error description; empty if successful. */
+        std::string message;
+        /** Version released; empty if the release failed. */
+        std::string version;
+        /** Wall time of the release. */
+        double wallMs;
+    };
+
+    BatchRelease();
+    ~BatchRelease();
+
+    BatchRelease(const BatchRelease &) = delete;
+    BatchRelease &operator=(const BatchRelease &) = delete;
+
+    /**
+     * @brief Read a list of repositories, one directory per line.
+     * @details Blank lines and lines starting with `#` are skipped.
+     * @returns `false` if the file cannot be read.
+     */
+    static bool readList(const std::filesystem::path &fileName, std::vector<std::string> &dirNames);
+
+    /** Add a repository to release. */
+    void addRepository(const std::string &dirName);
+
+    /** Repositories to release, in the order they were added. */
+    std::vector<std::string> repositories() const;
+
+    /** Set the number of repositories released at a time (the number of workers unless set). */
+    void setJobs(size_t jobs);
+
+    /** Number of repositories released at a time. */
+    size_t jobs() const;
+
+    /**
+     * @brief Use one config file for every repository.
+     * @details It is read once. If empty, each repository reads its own.
+     */
+    void setConfigFile(const std::string &fileName);
+
+    /**
+     * @brief Release every repository.
+     * @returns One result per repository, in the order they were added.
+     */
+    std::vector<Result> run();
+
+    /** Results as JSON. */
+    static std::string report(const std::vector<Result> &results);
+
+private:
+    BatchReleasePrivate *d;
+};
+
+}
@@ -4,7 +4,11 @@
  */
 #include "changelog.h"
 #include "cmark.h"
+#include "standard-release/stats/stats.h"
+#include "standard-release/trace/trace.h"
+#include <algorithm>
 #include <chrono>
+#include <cstdlib>
 #include <cstring>
 #include <ctime>
 #include <fstream>
@@ -58,12 +62,6 @@ static bool childrenAdded(cmark_node *node)
     return true;
 }
 
-static bool hasItems(cmark_node *node)
-{
-    cmark_node *item = cmark_node_first_child(node);
-    return cmark_node_get_type(item) == CMARK_NODE_NONE ? false : true;
-}
-
 static cmark_node *addSection(cmark_node *root, cmark_node *list, const char *name, int level)
 {
     cmark_node *header = cmark_node_new(CMARK_NODE_HEADING);
@@ -80,7 +78,8 @@ static cmark_node *addSection(cmark_node *root, cmark_node *list, const char *na
 }
 
 static void addItem(cmark_node *list, const std::string scope, const std::string subject,
-                    const std::string hash, const std::string url)
+                    const std::string hash, const std::string url,
+                    const std::vector<uint32_t> &references = {})
 {
     cmark_node *item = cmark_node_new(CMARK_NODE_ITEM);
     cmark_node *p = cmark_node_new(CMARK_NODE_PARAGRAPH);
@@ -104,6 +103,27 @@ static void addItem(cmark_node *list, const std::string scope, const std::string
     cmark_node_set_literal(subject_txt, subject.c_str());
     cmark_node_append_child(p, subject_txt);
 
+    if (!references.empty()) {
+        // GitHub redirects `/issues/N` to the pull request when N is one.
+        for (size_t i = 0; i < references.size(); i++) {
+            cmark_node *sep = cmark_node_new(CMARK_NODE_TEXT);
+            cmark_node_set_literal(sep, i == 0 ? " (" : ", ");
+            cmark_node_append_child(p, sep);
+
+            const std::string number = std::to_string(references[i]);
+            cmark_node *link = cmark_node_new(CMARK_NODE_LINK);
+            cmark_node *link_txt = cmark_node_new(CMARK_NODE_TEXT);
+            cmark_node_set_literal(link_txt, ("#" + number).c_str());
+            cmark_node_set_url(link, (url + "/issues/" + number).c_str());
+            cmark_node_append_child(link, link_txt);
+            cmark_node_append_child(p, link);
+        }
+
+        cmark_node *end = cmark_node_new(CMARK_NODE_TEXT);
+        cmark_node_set_literal(end, ")");
+        cmark_node_append_child(p, end);
+    }
+
     if (!hash.empty()) {
         cmark_node *begin = cmark_node_new(CMARK_NODE_TEXT);
         cmark_node_set_literal(begin, " (");
@@ -224,6 +244,8 @@ Changelog::~Changelog()
 
 void Changelog::read()
 {
+    TraceSpan span("changelog-read", "changelog");
+
     std::error_code code;
 
     if (d->root != nullptr) {
@@ -246,8 +268,13 @@ void Changelog::readFile()
     }
 
     d->root = cmark_parse_file(f, CMARK_OPT_DEFAULT);
+    const long bytes = ftell(f);
     fclose(f);
 
+    if (bytes > 0) {
+        Stats::add(Stats::BytesRead, bytes);
+    }
+
     if (d->root == nullptr) {
         // TODO: New error: Invalid CHANGELOG.
         setError(Error::InternalError);
@@ -275,10 +302,15 @@ void Changelog::readFile()
 
 void Changelog::write()
 {
+    TraceSpan span("changelog-write", "changelog");
+
     std::ofstream changelogFile;
+    const std::string text = content();
     changelogFile.open(filename());
-    changelogFile << content();
+    changelogFile << text;
     changelogFile.close();
+
+    Stats::add(Stats::BytesWritten, text.size());
 }
 
 // std::string Changelog::content() const {}
@@ -362,87 +394,118 @@ void Changelog::createFile()
     d->root = doc;
 }
 
-// TODO: Should extract url from origin be done here?
-void Changelog::generate(const SemVer current, const SemVer old,
-                         const IConventionalCommit::Commits commits, const std::string url)
+// Today's date, or an empty string on error.
+static std::string releaseDate()
 {
-    auto type = current.incrementType(old);
     char date[200];
+    std::time_t t = std::time(0);
+    std::tm *now = std::localtime(&t);
+    int ret = strftime(date, sizeof(date), "%G-%m-%d", now);
+    return ret == 0 ? std::string() : std::string(date);
+}
 
-    {
-        // Extract time
-        std::time_t t = std::time(0);
-        std::tm *now = std::localtime(&t);
-        int ret = strftime(date, sizeof(date), "%G-%m-%d", now);
-        if (ret == 0) {
-            setError(Error(Error::InternalError, "Invalid date format"));
-            return;
-        }
-    }
-
-    cmark_node *features_list = cmark_node_new(CMARK_NODE_LIST);
-    cmark_node *bugs_list = cmark_node_new(CMARK_NODE_LIST);
-    cmark_node *perf_list = cmark_node_new(CMARK_NODE_LIST);
-    cmark_node *reverts_list = cmark_node_new(CMARK_NODE_LIST);
+// Insert the anchor, header and sections of a release after `sibling`.
+static void addRelease(cmark_node *sibling, const SemVer current, const SemVer old,
+                       const CommitTable &commits, const std::string &url,
+                       const std::string &date, const CommitTypes &commitTypes,
+                       bool groupByScope)
+{
+    const auto groups = commits.groupByType();
 
-    cmark_node_set_list_tight(features_list, 1);
-    cmark_node_set_list_tight(bugs_list, 1);
-    cmark_node_set_list_tight(perf_list, 1);
-    cmark_node_set_list_tight(reverts_list, 1);
+    sibling = generateReleaseHeader(sibling, current, old, url, date);
 
-    // std::cout << "---\n";
+    const int level = getHeaderLevel(current, old, HeaderType::Section);
 
-    for (const auto commit : commits) {
-        if (commit.feature) {
-            addItem(features_list, commit.scope, commit.subject, commit.hash, url);
-        } else if (commit.bugfix) {
-            addItem(bugs_list, commit.scope, commit.subject, commit.hash, url);
-        } else if (commit.type == "perf") {
-            addItem(perf_list, commit.scope, commit.subject, commit.hash, url);
-        } else if (commit.type == "revert") {
-            addItem(reverts_list, commit.scope, commit.subject, commit.hash, url);
+    // One section per title, in type order; types without a title are left out.
+    for (const auto &title : commitTypes.sections()) {
+        std::vector<uint32_t> rows;
+        for (size_t type = 0; type < commitTypes.size(); type++) {
+            if (commitTypes.type(type).section == title) {
+                rows.insert(rows.end(), groups.rows.begin() + groups.begin[type],
+                            groups.rows.begin() + groups.begin[type + 1]);
+            }
+        }
+        if (rows.empty()) {
+            continue;
         }
-    }
-
-    cmark_node *sibling = findInsertNode(d->root);
 
-    sibling = generateReleaseHeader(sibling, current, old, url, date);
+        // Types sharing a section are listed in commit order, or by scope.
+        std::sort(rows.begin(), rows.end());
+        if (groupByScope) {
+            commits.sortByScope(rows);
+        }
 
-    const int level = getHeaderLevel(current, old, HeaderType::Section);
+        cmark_node *list = cmark_node_new(CMARK_NODE_LIST);
+        cmark_node_set_list_tight(list, 1);
 
-    // Add features.
-    if (hasItems(features_list)) {
-        sibling = addSection(sibling, features_list, "Features", level);
-    } else {
-        cmark_node_free(features_list);
-    }
+        for (const uint32_t row : rows) {
+            addItem(list, std::string(commits.scope(row)), std::string(commits.subject(row)),
+                    std::string(commits.hash(row)), url, commits.references(row));
+        }
 
-    // Add bug fixes.
-    if (hasItems(bugs_list)) {
-        sibling = addSection(sibling, bugs_list, "Bug Fixes", level);
-    } else {
-        cmark_node_free(bugs_list);
+        sibling = addSection(sibling, list, title.c_str(), level);
     }
+}
 
-    if (hasItems(perf_list)) {
-        sibling = addSection(sibling, perf_list, "Performance Improvements", level);
-    } else {
-        cmark_node_free(perf_list);
-    }
+// TODO: Should extract url from origin be done here?
+void Changelog::generate(const SemVer current, const SemVer old, const CommitTable &commits,
+                         const std::string url)
+{
+    TraceSpan span("changelog-generate", "changelog");
 
-    if (hasItems(reverts_list)) {
-        sibling = addSection(sibling, reverts_list, "Reverts", level);
-    } else {
-        cmark_node_free(reverts_list);
+    const std::string date = releaseDate();
+    if (date.empty()) {
+        setError(Error(Error::InternalError, "Invalid date format"));
+        return;
     }
 
-    // TODO: Should "Build System", "Tests", "Docs", etc be included?
+    addRelease(findInsertNode(d->root), current, old, commits, url, date, types(),
+               groupByScope());
 
     char *data = cmark_render_commonmark(d->root, CMARK_OPT_DEFAULT, 0);
     setContent(data);
-    delete data;
+    free(data);
 
     // std::cout << content();
 
     // std::cout << "---\n";
 }
+
+std::string Changelog::renderRelease(const SemVer current, const SemVer old,
+                                     const CommitTable &commits, const std::string url) const
+{
+    // Rendered in a document of its own, after a placeholder that is removed again.
+    cmark_node *doc = cmark_node_new(CMARK_NODE_DOCUMENT);
+    cmark_node *start = cmark_node_new(CMARK_NODE_PARAGRAPH);
+    cmark_node_append_child(doc, start);
+
+    addRelease(start, current, old, commits, url, releaseDate(), types(), groupByScope());
+    cmark_node_free(start);
+
+    char *data = cmark_render_commonmark(doc, CMARK_OPT_DEFAULT, 0);
+    const std::string block = data;
+    free(data);
+    cmark_node_free(doc);
+
+    return block;
+}
+
+void Changelog::insertRelease(const std::string &entry)
+{
+    TraceSpan span("changelog-generate", "changelog");
+
+    cmark_node *doc = cmark_parse_document(entry.c_str(), entry.size(), CMARK_OPT_DEFAULT);
+    cmark_node *sibling = findInsertNode(d->root);
+
+    // Move the blocks of the entry over, keeping their order.
+    while (cmark_node *node = cmark_node_first_child(doc)) {
+        cmark_node_unlink(node);
+        cmark_node_insert_after(sibling, node);
+        sibling = node;
+    }
+    cmark_node_free(doc);
+
+    char *data = cmark_render_commonmark(d->root, CMARK_OPT_DEFAULT, 0);
+    setContent(data);
+    free(data);
+}
@@ -24,10 +24,15 @@ public:
     Changelog(const std::string filename);
     ~Changelog();
 
+    using IChangelog::generate;
+
     void read();
     void write();
-    void generate(const SemVer version, const SemVer old,
-                  const IConventionalCommit::Commits commits, const std::string url);
+    void generate(const SemVer version, const SemVer old, const CommitTable &commits,
+                  const std::string url);
+    std::string renderRelease(const SemVer version, const SemVer old, const CommitTable &commits,
+                              const std::string url) const;
+    void insertRelease(const std::string &entry);
 
 private:
     void readFile();
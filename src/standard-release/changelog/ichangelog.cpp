@@ -8,6 +8,8 @@ struct StandardRelease::IChangelogPrivate
     Error error;
     std::string filename;
     IConventionalCommit::Commits commits;
+    CommitTypes types;
+    bool groupByScope = false;
     bool exists;
     std::string content;
 };
@@ -56,11 +58,37 @@ std::string IChangelog::filename() const
     return d->filename;
 }
 
+void IChangelog::setTypes(const CommitTypes &types)
+{
+    d->types = types;
+}
+
+const CommitTypes &IChangelog::types() const
+{
+    return d->types;
+}
+
+void IChangelog::setGroupByScope(bool group)
+{
+    d->groupByScope = group;
+}
+
+bool IChangelog::groupByScope() const
+{
+    return d->groupByScope;
+}
+
 bool IChangelog::exists() const
 {
     return d->exists;
 }
 
+void IChangelog::generate(const SemVer version, const SemVer old,
+                          const IConventionalCommit::Commits commits, const std::string origin)
+{
+    generate(version, old, IConventionalCommit::toTable(commits, types()), origin);
+}
+
 IConventionalCommit::Commits IChangelog::commits() const
 {
     return d->commits;
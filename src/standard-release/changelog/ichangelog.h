@@ -25,7 +25,7 @@ public:
     IChangelog();
     /** Initialize a new changelog from a file path. */
     IChangelog(const std::string filename);
-    ~IChangelog();
+    virtual ~IChangelog();
 
     /** Set the current path to the changelog. */
     void setFilename(const std::string filename);
@@ -42,6 +42,18 @@ public:
     /** Path to the file. */
     std::string filename() const;
 
+    /** Set the commit types and their sections (CommitTypes::defaults() unless set). */
+    void setTypes(const CommitTypes &types);
+
+    /** Commit types and their sections. */
+    const CommitTypes &types() const;
+
+    /** Sort the entries of each section by scope instead of by commit. */
+    void setGroupByScope(bool group);
+
+    /** Are the entries of each section sorted by scope? */
+    bool groupByScope() const;
+
     /** Does the file currently exist? */
     bool exists() const;
 
@@ -57,8 +69,27 @@ public:
      * final format.
      * @note Must be called AFTER read() but before write()!
      */
-    virtual void generate(const SemVer version, const SemVer old,
-                          const IConventionalCommit::Commits commits, const std::string origin) = 0;
+    virtual void generate(const SemVer version, const SemVer old, const CommitTable &commits,
+                          const std::string origin) = 0;
+
+    /** @overload */
+    void generate(const SemVer version, const SemVer old,
+                  const IConventionalCommit::Commits commits, const std::string origin);
+
+    /**
+     * @brief Render the entry of a release on its own.
+     * @details Unlike generate(), the changelog is left unchanged and read() is not needed.
+     * @returns The entry in the format of the changelog.
+     */
+    virtual std::string renderRelease(const SemVer version, const SemVer old,
+                                      const CommitTable &commits,
+                                      const std::string origin) const = 0;
+
+    /**
+     * @brief Add an entry rendered by renderRelease() as the newest release.
+     * @note Like generate(), must be called after read() and before write().
+     */
+    virtual void insertRelease(const std::string &entry) = 0;
 
 protected:
     void setContent(const std::string content);
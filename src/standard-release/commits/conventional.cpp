@@ -1,22 +1,66 @@
 #include "conventional.h"
+#include "standard-release/commits/references.h"
+#include "standard-release/stats/stats.h"
+#include "standard-release/trace/trace.h"
+#include <algorithm>
+#include <cctype>
 #include <iostream>
 #include <regex>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 using namespace StandardRelease;
 
-static const std::string COMMIT = "^([a-zA-Z]+)(\\([a-zA-Z]+\\))?(!?): ([^\\n]+)$";
-static const std::string TYPES = "^(build|ci|chore|docs|feat|fix|perf|refactor|revert|style|test)$";
+// Type, comma-separated scopes (letters, digits, `_`, `.`, `-` and `/`), breaking marker, subject.
+static const std::string COMMIT = "^([a-zA-Z]+)(?:\\(([\\w./,\\- ]+)\\))?(!?): ([^\\n]+)$";
 
-inline std::vector<std::string> split(const std::string &s, char delimiter)
+// ID in a `This reverts commit <id>.` line (written by `git revert`), or an empty view.
+static std::string_view revertedCommit(std::string_view body)
 {
-    std::vector<std::string> tokens;
-    std::string token;
-    std::istringstream stream(s);
-    while (std::getline(stream, token, delimiter)) {
-        tokens.push_back(token);
+    static const std::string_view TRAILER = "This reverts commit ";
+
+    const size_t pos = body.find(TRAILER);
+    if (pos == std::string_view::npos) {
+        return {};
+    }
+
+    const std::string_view rest = body.substr(pos + TRAILER.size());
+    size_t length = 0;
+    while (length < rest.size() && std::isxdigit(static_cast<unsigned char>(rest[length]))) {
+        length++;
+    }
+    return rest.substr(0, length);
+}
+
+// Remove a trailing ` (#123)` (added by GitHub to squash merges); the number is linked instead.
+static void stripPullRequest(std::string &subject)
+{
+    const size_t open = subject.rfind(" (#");
+    if (open == std::string::npos || subject.back() != ')' || subject.size() - open < 5) {
+        return;
     }
-    return tokens;
+    for (size_t i = open + 3; i < subject.size() - 1; i++) {
+        if (subject[i] < '0' || subject[i] > '9') {
+            return;
+        }
+    }
+    subject.erase(open);
+}
+
+// Rows of `table` except the dropped ones, in the same order.
+static CommitTable withoutRows(const CommitTable &table, const std::vector<bool> &dropped)
+{
+    CommitTable kept;
+    kept.reserve(table.size());
+    for (size_t row = 0; row < table.size(); row++) {
+        if (!dropped[row]) {
+            kept.append(table.type(row), table.scope(row), table.subject(row), table.hash(row),
+                        table.flags(row), table.references(row));
+        }
+    }
+    return kept;
 }
 
 ConventionalCommits::ConventionalCommits()
@@ -26,64 +70,165 @@ ConventionalCommits::ConventionalCommits()
 
 bool ConventionalCommits::parseCommits(const GitRepository::Commits commits)
 {
-    GitRepository::Commits gitcommits = commits;
-    Commits conventionalcommits;
-
-    for (const auto gitcommit : gitcommits) {
-        const auto gitsummary = gitcommit.summary;
-        const auto gitbody = gitcommit.body;
-        const auto githash = gitcommit.hash;
-
-        std::smatch match;
-        std::regex_search(gitsummary, match, std::regex(COMMIT));
-        if (match.empty()) {
-            // Not conventional commit format. Skipping.
-            continue;
-        }
+    TraceSpan span("parse", "commits");
+
+    CommitTable table;
+    bool released = false;
+
+    m_patchIds.clear();
+    if (!parse(commits, table, released)) {
+        return false;
+    }
 
-        const std::string typestr = match[1];
-        std::string scope = match[2];
-        bool breaking = (match[3] == "!");
-        std::string subject = match[4];
+    setTable(std::move(table));
 
-        // Remove "()" from scope.
-        if (!scope.empty()) {
-            scope = scope.substr(1, scope.length() - 2);
+    setError(Error::Success);
+    return false;
+}
+
+bool ConventionalCommits::appendCommits(const GitRepository::Commits commits)
+{
+    TraceSpan span("parse-append", "commits");
+
+    // A revert or a duplicate changes the entries that are already listed.
+    for (const auto &commit : commits) {
+        if (!revertedCommit(commit.body()).empty()
+            || (!commit.patchId.empty() && m_patchIds.count(commit.patchId) > 0)) {
+            return false;
         }
+    }
+
+    CommitTable added;
+    bool released = false;
+    if (!parse(commits, added, released) || released) {
+        return false;
+    }
+
+    CommitTable merged = table();
+    merged.reserve(merged.size() + added.size());
+    for (size_t row = 0; row < added.size(); row++) {
+        merged.append(added.type(row), added.scope(row), added.subject(row), added.hash(row),
+                      added.flags(row), added.references(row));
+    }
+    setTable(std::move(merged));
+
+    setError(Error::Success);
+    return true;
+}
+
+// Parse commits (newest first) into rows, oldest first. `released` is set if a release commit
+// ended the range.
+bool ConventionalCommits::parse(const GitRepository::Commits &gitcommits, CommitTable &table,
+                                bool &released)
+{
+    table.reserve(gitcommits.size());
+
+    // Every commit in the release, newest first, and its rows in `table`.
+    struct Walked
+    {
+        std::string_view id;
+        std::string_view reverts;
+        uint32_t row;
+        uint32_t rows;
+    };
+    std::vector<Walked> walked;
+    walked.reserve(gitcommits.size());
+
+    // A commit listed in a squash merge body.
+    struct Squashed
+    {
+        int type;
+        std::string scope;
+        std::string subject;
+        bool breaking;
+        std::vector<uint32_t> references;
+    };
+    std::vector<Squashed> squashed;
+    const std::regex commitLine(COMMIT);
+    const std::regex squashedLine(expandSquashes() ? "^[*-] " + COMMIT.substr(1) : "");
 
-        // Only store commits AFTER `chore(release): x.y.z`
-        if (typestr == "chore" && scope == "release") {
-            // TODO: Maybe use version stored in subject somehow?
-            break;
+    for (const auto &gitcommit : gitcommits) {
+        const std::string_view gitsummary = gitcommit.summary();
+        const std::string_view gitbody = gitcommit.body();
+        const auto &githash = gitcommit.hash;
+
+        std::cmatch match;
+        std::regex_search(gitsummary.data(), gitsummary.data() + gitsummary.size(), match,
+                          commitLine);
+        const bool conventional = !match.empty();
+        if (!conventional && !expandSquashes()) {
+            // Not conventional commit format. Skipping, but a plain `Revert "..."` still counts.
+            walked.push_back({ gitcommit.id, revertedCommit(gitbody), 0, 0 });
+            continue;
         }
 
-        // Check if type is valid.
-        std::regex_search(typestr, match, std::regex(TYPES));
-        if (match.empty()) {
-            setError(Error(Error::ConventionalUnrecognizedType, typestr));
-            return false;
+        std::string typestr;
+        std::string scope;
+        bool breaking = false;
+        std::string subject;
+        int type = -1;
+
+        if (conventional) {
+            typestr = match[1];
+            scope = match[2];
+            breaking = (match[3] == "!");
+            subject = match[4];
+
+            // Only store commits AFTER `chore(release): x.y.z`
+            if (typestr == "chore" && scope == "release") {
+                // TODO: Maybe use version stored in subject somehow?
+                released = true;
+                break;
+            }
+
+            // Check if type is valid.
+            type = types().find(typestr);
+            if (type < 0) {
+                setError(Error(Error::ConventionalUnrecognizedType, typestr));
+                return false;
+            }
         }
 
-        // Parse body.
+        walked.push_back({ gitcommit.id, revertedCommit(gitbody), 0, 0 });
+
+        // Parse body. Footers and squashed commits are found in the same pass, bottom up.
         std::string body = "";
         bool parsebody = false;
-        if (!gitbody.empty()) {
-            std::vector lines = split(gitbody, '\n');
-            std::reverse(lines.begin(), lines.end());
-            for (auto line : lines) {
-                if (!parsebody) {
-                    if (line.find("BREAKING CHANGE: ") != std::string::npos) {
-                        breaking = true;
-                    } else if (line.find("BREAKING-CHANGE: ") != std::string::npos) {
-                        breaking = true;
-                    } else if (line == "") {
-                        parsebody = true;
-                        continue;
+        squashed.clear();
+        // Lines are views into the message, taken from the end.
+        std::string_view lines = gitbody;
+        while (!lines.empty()) {
+            const size_t newline = lines.rfind('\n');
+            const size_t begin = newline == std::string_view::npos ? 0 : newline + 1;
+            const std::string_view line = lines.substr(begin);
+            lines = lines.substr(0, begin == 0 ? 0 : newline);
+            if (expandSquashes() && line.size() > 2 && (line[0] == '*' || line[0] == '-')
+                && line[1] == ' ') {
+                std::cmatch item;
+                if (std::regex_search(line.data(), line.data() + line.size(), item,
+                                      squashedLine)) {
+                    const int itemType = types().find(item[1].str());
+                    // Free text, so unknown types are not an error.
+                    if (itemType >= 0 && !(item[1] == "chore" && item[2] == "release")) {
+                        Squashed commit { itemType, item[2], item[4], item[3] == "!", {} };
+                        findReferences(commit.subject, commit.references);
+                        stripPullRequest(commit.subject);
+                        squashed.push_back(std::move(commit));
                     }
-                } else {
-                    // TODO: Maybe handle if line.length() > 100 (?)
                 }
             }
+            if (!parsebody) {
+                if (line.find("BREAKING CHANGE: ") != std::string_view::npos) {
+                    breaking = true;
+                } else if (line.find("BREAKING-CHANGE: ") != std::string_view::npos) {
+                    breaking = true;
+                } else if (line == "") {
+                    parsebody = true;
+                    continue;
+                }
+            } else {
+                // TODO: Maybe handle if line.length() > 100 (?)
+            }
         }
 
 #if 0
@@ -95,44 +240,90 @@ bool ConventionalCommits::parseCommits(const GitRepository::Commits commits)
             std::cout << "   BREAKING CHANGE" << std::endl;
 #endif
 
-        Commit commit(typestr, scope, subject);
-        commit.breaking = breaking;
-        commit.feature = commit.type == "feat" ? true : false;
-        commit.bugfix = commit.type == "fix" ? true : false;
-        commit.hash = githash;
-        conventionalcommits.push_back(commit);
+        // Cherry-picks and backports repeat a change; only the newest copy is listed.
+        if (!gitcommit.patchId.empty() && !m_patchIds.insert(gitcommit.patchId).second) {
+            continue;
+        }
+
+        walked.back().row = static_cast<uint32_t>(table.size());
+
+        // Rows are reversed at the end, so squashed commits are added last to first and follow
+        // the squash merge itself in the changelog.
+        for (const auto &commit : squashed) {
+            const uint8_t flags
+                    = (commit.breaking ? CommitTable::Breaking : 0) | types().flags(commit.type);
+            table.append(static_cast<CommitTable::Type>(commit.type), commit.scope,
+                         commit.subject, githash, flags, commit.references);
+        }
+
+        if (conventional) {
+            std::vector<uint32_t> references;
+            findReferences(subject, references);
+            findReferences(gitbody, references);
+            std::sort(references.begin(), references.end());
+            references.erase(std::unique(references.begin(), references.end()),
+                             references.end());
+            stripPullRequest(subject);
+
+            const uint8_t flags = (breaking ? CommitTable::Breaking : 0) | types().flags(type);
+            table.append(static_cast<CommitTable::Type>(type), scope, subject, githash, flags,
+                         references);
+        }
+
+        walked.back().rows = static_cast<uint32_t>(table.size()) - walked.back().row;
+        if (walked.back().rows > 0) {
+            Stats::add(Stats::CommitsParsed);
+        }
+    }
+
+    // A revert and the commit it reverts cancel out when both are in the release. Pairing
+    // newest first means a reverted revert is dropped with its revert and leaves the original.
+    std::unordered_map<std::string_view, size_t> index;
+    index.reserve(walked.size());
+    for (size_t i = 0; i < walked.size(); i++) {
+        if (!walked[i].id.empty()) {
+            index.emplace(walked[i].id, i);
+        }
     }
 
-    std::reverse(conventionalcommits.begin(), conventionalcommits.end());
+    std::vector<bool> cancelled(walked.size(), false);
+    std::vector<bool> dropped(table.size(), false);
+    bool anyDropped = false;
+    for (size_t i = 0; i < walked.size(); i++) {
+        if (cancelled[i] || walked[i].reverts.empty()) {
+            continue;
+        }
+        const auto target = index.find(walked[i].reverts);
+        if (target == index.end() || target->second <= i || cancelled[target->second]) {
+            continue;
+        }
+        for (const size_t pair : { i, target->second }) {
+            cancelled[pair] = true;
+            for (uint32_t row = 0; row < walked[pair].rows; row++) {
+                dropped[walked[pair].row + row] = true;
+                anyDropped = true;
+            }
+        }
+    }
+    if (anyDropped) {
+        table = withoutRows(table, dropped);
+    }
 
-    setCommits(conventionalcommits);
+    table.reverse();
 
-    setError(Error::Success);
-    return false;
+    return true;
 }
 
 void ConventionalCommits::bump()
 {
-    bool major = false;
-    bool minor = false;
-    bool patch = false;
+    const uint8_t flags = table().combinedFlags();
     SemVer v = version();
 
-    for (auto commit : commits()) {
-        if (commit.breaking) {
-            major = true;
-        } else if (commit.feature) {
-            minor = true;
-        } else if (commit.bugfix) {
-            patch = true;
-        }
-    }
-
-    if (major) {
+    if (flags & CommitTable::Breaking) {
         v.increment(SemVer::Major);
-    } else if (minor) {
+    } else if (flags & CommitTable::Feature) {
         v.increment(SemVer::Minor);
-    } else if (patch) {
+    } else if (flags & CommitTable::Bugfix) {
         v.increment(SemVer::Patch);
     }
 
@@ -7,6 +7,7 @@
 #include "standard-release/commits/iconventional.h"
 #include <list>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 namespace StandardRelease {
@@ -21,8 +22,24 @@ public:
 
     bool parseCommits(const GitRepository::Commits commits);
 
+    /**
+     * @brief Add commits made after the ones already parsed.
+     * @details Only the new commits are parsed; their rows are added after the existing ones.
+     * @param[in] commits The new commits, newest first (see GitRepository::update()).
+     * @returns `false` if the new commits change earlier entries (a revert, a cherry-pick of a
+     * listed change or a new release) or have an unknown type. The table is then unchanged and
+     * parseCommits() must be run on the whole range.
+     */
+    bool appendCommits(const GitRepository::Commits commits);
+
     /** Bump the current version based on commits. */
     void bump();
+
+private:
+    bool parse(const GitRepository::Commits &commits, CommitTable &table, bool &released);
+
+    /** Patch IDs of the parsed commits. */
+    std::unordered_set<std::string> m_patchIds;
 };
 
 };
@@ -10,7 +10,9 @@ using namespace StandardRelease;
 IConventionalCommit::IConventionalCommit()
     : m_valid(false)
     , m_error()
-    , m_commits()
+    , m_table()
+    , m_types()
+    , m_expandSquashes(false)
     , m_semver()
 {
 }
@@ -25,6 +27,26 @@ SemVer IConventionalCommit::version() const {
     return m_semver;
 }
 
+void IConventionalCommit::setTypes(const CommitTypes &types)
+{
+    m_types = types;
+}
+
+const CommitTypes &IConventionalCommit::types() const
+{
+    return m_types;
+}
+
+void IConventionalCommit::setExpandSquashes(bool enabled)
+{
+    m_expandSquashes = enabled;
+}
+
+bool IConventionalCommit::expandSquashes() const
+{
+    return m_expandSquashes;
+}
+
 void IConventionalCommit::setValid(bool valid) {
     m_valid = valid;
 }
@@ -35,11 +57,53 @@ void IConventionalCommit::setError(const Error error)
 }
 
 void IConventionalCommit::setCommits(const IConventionalCommit::Commits commits) {
-    m_commits = commits;
+    m_table = toTable(commits, m_types);
+}
+
+void IConventionalCommit::setTable(CommitTable &&table)
+{
+    m_table = std::move(table);
 }
 
 IConventionalCommit::Commits IConventionalCommit::commits() const {
-    return m_commits;
+    Commits commits;
+    commits.reserve(m_table.size());
+
+    for (size_t row = 0; row < m_table.size(); row++) {
+        const auto flags = m_table.flags(row);
+        commits.emplace_back(m_types.type(m_table.type(row)).name,
+                             std::string(m_table.scope(row)), std::string(m_table.subject(row)),
+                             std::string(m_table.hash(row)), (flags & CommitTable::Breaking) != 0,
+                             (flags & CommitTable::Feature) != 0,
+                             (flags & CommitTable::Bugfix) != 0, m_table.references(row));
+    }
+    return commits;
+}
+
+const CommitTable &IConventionalCommit::table() const
+{
+    return m_table;
+}
+
+CommitTable IConventionalCommit::toTable(const Commits &commits, const CommitTypes &types)
+{
+    CommitTable table;
+    table.reserve(commits.size());
+
+    for (const auto &commit : commits) {
+        const int type = types.find(commit.type);
+        if (type < 0) {
+            // Only known types can be stored; the parser rejects everything else.
+            continue;
+        }
+
+        const uint8_t flags = (commit.breaking ? CommitTable::Breaking : 0)
+                | (commit.feature ? CommitTable::Feature : 0)
+                | (commit.bugfix ? CommitTable::Bugfix : 0);
+        table.append(static_cast<CommitTable::Type>(type), commit.scope, commit.subject,
+                     commit.hash, flags, commit.references);
+    }
+    return table;
 }
 
 bool IConventionalCommit::isValid() const {
@@ -4,6 +4,8 @@
  */
 #pragma once
 
+#include "standard-release/commits/table.h"
+#include "standard-release/commits/types.h"
 #include "standard-release/errors/errors.h"
 #include "standard-release/git/repository.h"
 #include "standard-release/global/global.h"
@@ -23,7 +25,7 @@ class STANDARDRELEASE_EXPORT IConventionalCommit
 {
 public:
     IConventionalCommit();
-    ~IConventionalCommit();
+    virtual ~IConventionalCommit();
 
     struct Commit
     {
@@ -34,10 +36,12 @@ public:
         bool breaking;
         bool feature;
         bool bugfix;
+        /** Issue and pull request numbers the commit refers to. */
+        std::vector<uint32_t> references;
 
         Commit(const std::string type, const std::string scope, const std::string subject,
                const std::string hash = "", bool breaking = false, bool feature = false,
-               bool bugfix = false)
+               bool bugfix = false, const std::vector<uint32_t> references = {})
         {
             this->type = type;
             this->scope = scope;
@@ -46,6 +50,7 @@ public:
             this->breaking = breaking;
             this->feature = feature;
             this->bugfix = bugfix;
+            this->references = references;
         }
     };
 
@@ -55,6 +60,18 @@ public:
     void setVersion(const SemVer &semver);
     /** Get the current version. */
     SemVer version() const;
+    /** Set the accepted commit types (CommitTypes::defaults() unless set). */
+    void setTypes(const CommitTypes &types);
+    /** Accepted commit types. */
+    const CommitTypes &types() const;
+    /**
+     * @brief List the conventional lines in a commit body (`* feat(x): ...`) as commits too.
+     * @details Squash merges list the commits they combine this way. Each line becomes its own
+     * entry with the hash of the squash merge.
+     */
+    void setExpandSquashes(bool enabled);
+    /** Are conventional lines in commit bodies listed as commits? */
+    bool expandSquashes() const;
     /** Returns `true` if commits meet the conventionalcommit.org standard; `false` otherwise. */
     bool isValid() const;
     /** Current status. */
@@ -66,17 +83,28 @@ public:
     /** Bump the current version based on commits. */
     virtual void bump() = 0;
 
+    /** Parsed commits, one Commit per row of table(). */
     Commits commits() const;
 
+    /** Parsed commits. */
+    const CommitTable &table() const;
+
+    /** Commits as a table; commits of types not in @p types are left out. */
+    static CommitTable toTable(const Commits &commits,
+                               const CommitTypes &types = CommitTypes::defaults());
+
 protected:
     void setValid(bool valid);
     void setCommits(const Commits commits);
+    void setTable(CommitTable &&table);
     void setError(const Error error);
 
 private:
     bool m_valid;
     Error m_error;
-    Commits m_commits;
+    CommitTable m_table;
+    CommitTypes m_types;
+    bool m_expandSquashes;
     SemVer m_semver;
 };
 
@@ -0,0 +1,108 @@
+#include "references.h"
+#include <cctype>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define STANDARDRELEASE_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace StandardRelease;
+
+static bool isWordChar(char c)
+{
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+static bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// A whole word of at most 9 digits starting at `pos`.
+static bool readNumber(std::string_view text, size_t pos, uint32_t &number)
+{
+    uint32_t value = 0;
+    size_t end = pos;
+    while (end < text.size() && isDigit(text[end])) {
+        if (end - pos == 9) {
+            return false;
+        }
+        value = value * 10 + static_cast<uint32_t>(text[end] - '0');
+        end++;
+    }
+    if (end == pos || (end < text.size() && isWordChar(text[end]))) {
+        return false;
+    }
+    number = value;
+    return true;
+}
+
+// Check whether the `#` or `-` at `pos` is part of a reference.
+static void checkAnchor(std::string_view text, size_t pos, std::vector<uint32_t> &numbers)
+{
+    size_t start = pos;
+    if (text[pos] == '-') {
+        if (pos < 2 || std::toupper(static_cast<unsigned char>(text[pos - 2])) != 'G'
+            || std::toupper(static_cast<unsigned char>(text[pos - 1])) != 'H') {
+            return;
+        }
+        start = pos - 2;
+    }
+
+    if (start > 0) {
+        const char before = text[start - 1];
+        if (isWordChar(before) || before == '/' || before == '&') {
+            return;
+        }
+    }
+
+    uint32_t number = 0;
+    if (readNumber(text, pos + 1, number) && number > 0) {
+        numbers.push_back(number);
+    }
+}
+
+#ifdef STANDARDRELEASE_SSE2
+static int lowestBit(unsigned int mask)
+{
+#if defined(__GNUC__)
+    return __builtin_ctz(mask);
+#else
+    int bit = 0;
+    while (!(mask & 1)) {
+        mask >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+#endif
+
+void StandardRelease::findReferences(std::string_view text, std::vector<uint32_t> &numbers)
+{
+    const char *data = text.data();
+    const size_t size = text.size();
+    size_t pos = 0;
+
+#ifdef STANDARDRELEASE_SSE2
+    // Compare 16 bytes at a time against both anchors; only the matching bytes are inspected.
+    const __m128i hash = _mm_set1_epi8('#');
+    const __m128i dash = _mm_set1_epi8('-');
+    for (; pos + 16 <= size; pos += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos));
+        const __m128i anchors
+                = _mm_or_si128(_mm_cmpeq_epi8(chunk, hash), _mm_cmpeq_epi8(chunk, dash));
+        unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(anchors));
+        while (mask) {
+            checkAnchor(text, pos + lowestBit(mask), numbers);
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    for (; pos < size; pos++) {
+        if (data[pos] == '#' || data[pos] == '-') {
+            checkAnchor(text, pos, numbers);
+        }
+    }
+}
@@ -0,0 +1,25 @@
+/**
+ * @file "standard-release/commits/references.h"
+ * @brief Issue and pull request references in commit messages.
+ */
+#pragma once
+
+#include "standard-release/global/global.h"
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace StandardRelease {
+
+/**
+ * @brief Find the issue and pull request numbers a text refers to.
+ * @details Recognizes `#123` (including `Closes #123`, `Fixes #123`, ...) and `GH-123`.
+ * References to other repositories (`owner/repo#123`) and numbers glued to a word (`abc#123`,
+ * `&#123;`) are ignored. The text is searched for the `#` and `-` anchors 16 bytes at a time
+ * where SSE2 is available, so long generated bodies are only inspected around those bytes.
+ * @param[in] text Commit subject or body.
+ * @param[in,out] numbers The numbers found are appended, in the order they appear.
+ */
+STANDARDRELEASE_EXPORT void findReferences(std::string_view text, std::vector<uint32_t> &numbers);
+
+}
@@ -0,0 +1,267 @@
+#include "table.h"
+#include <algorithm>
+
+using namespace StandardRelease;
+
+// Reverse the rows of a column of variable-length runs (`offsets` has one more entry than rows).
+static void reverseRuns(std::vector<uint32_t> &offsets, std::vector<uint32_t> &values)
+{
+    std::vector<uint32_t> reversedOffsets { 0 };
+    std::vector<uint32_t> reversedValues;
+    reversedOffsets.reserve(offsets.size());
+    reversedValues.reserve(values.size());
+    for (size_t row = offsets.size() - 1; row > 0; row--) {
+        reversedValues.insert(reversedValues.end(), values.begin() + offsets[row - 1],
+                              values.begin() + offsets[row]);
+        reversedOffsets.push_back(static_cast<uint32_t>(reversedValues.size()));
+    }
+    offsets = std::move(reversedOffsets);
+    values = std::move(reversedValues);
+}
+
+CommitTable::CommitTable()
+    : m_scopeOffsets { 0 }
+    , m_referenceOffsets { 0 }
+    , m_scopes { "" }
+{
+}
+
+void CommitTable::reserve(size_t rows)
+{
+    m_types.reserve(rows);
+    m_flags.reserve(rows);
+    m_scopeLabels.reserve(rows);
+    m_scopeOffsets.reserve(rows + 1);
+    m_scopeIds.reserve(rows);
+    m_referenceOffsets.reserve(rows + 1);
+    m_subjects.reserve(rows);
+    m_hashes.reserve(rows);
+    // Headers are short: a subject and an abbreviated hash fit in about this much.
+    m_text.reserve(rows * 64);
+}
+
+size_t CommitTable::append(Type type, std::string_view scope, std::string_view subject,
+                           std::string_view hash, uint8_t flags,
+                           const std::vector<uint32_t> &references)
+{
+    m_types.push_back(type);
+    m_flags.push_back(flags);
+    m_scopeLabels.push_back(storeScopes(scope));
+    m_subjects.push_back(store(subject));
+    m_hashes.push_back(store(hash));
+    m_references.insert(m_references.end(), references.begin(), references.end());
+    m_referenceOffsets.push_back(static_cast<uint32_t>(m_references.size()));
+    return m_types.size() - 1;
+}
+
+void CommitTable::reverse()
+{
+    std::reverse(m_types.begin(), m_types.end());
+    std::reverse(m_flags.begin(), m_flags.end());
+    std::reverse(m_scopeLabels.begin(), m_scopeLabels.end());
+    std::reverse(m_subjects.begin(), m_subjects.end());
+    std::reverse(m_hashes.begin(), m_hashes.end());
+
+    reverseRuns(m_scopeOffsets, m_scopeIds);
+    reverseRuns(m_referenceOffsets, m_references);
+}
+
+void CommitTable::clear()
+{
+    m_types.clear();
+    m_flags.clear();
+    m_scopeLabels.clear();
+    m_scopeOffsets.assign(1, 0);
+    m_scopeIds.clear();
+    m_referenceOffsets.assign(1, 0);
+    m_references.clear();
+    m_subjects.clear();
+    m_hashes.clear();
+    m_text.clear();
+    m_scopes.resize(1);
+    m_scopeIndex.clear();
+}
+
+size_t CommitTable::size() const
+{
+    return m_types.size();
+}
+
+bool CommitTable::empty() const
+{
+    return m_types.empty();
+}
+
+CommitTable::Type CommitTable::type(size_t row) const
+{
+    return m_types[row];
+}
+
+uint8_t CommitTable::flags(size_t row) const
+{
+    return m_flags[row];
+}
+
+size_t CommitTable::scopeCount(size_t row) const
+{
+    return m_scopeOffsets[row + 1] - m_scopeOffsets[row];
+}
+
+uint32_t CommitTable::scopeId(size_t row, size_t index) const
+{
+    return index < scopeCount(row) ? m_scopeIds[m_scopeOffsets[row] + index] : 0;
+}
+
+std::string_view CommitTable::scope(size_t row) const
+{
+    const auto span = m_scopeLabels[row];
+    return std::string_view(m_text).substr(span.offset, span.length);
+}
+
+std::string_view CommitTable::subject(size_t row) const
+{
+    const auto span = m_subjects[row];
+    return std::string_view(m_text).substr(span.offset, span.length);
+}
+
+std::string_view CommitTable::hash(size_t row) const
+{
+    const auto span = m_hashes[row];
+    return std::string_view(m_text).substr(span.offset, span.length);
+}
+
+size_t CommitTable::referenceCount(size_t row) const
+{
+    return m_referenceOffsets[row + 1] - m_referenceOffsets[row];
+}
+
+uint32_t CommitTable::reference(size_t row, size_t index) const
+{
+    return m_references[m_referenceOffsets[row] + index];
+}
+
+std::vector<uint32_t> CommitTable::references(size_t row) const
+{
+    return std::vector<uint32_t>(m_references.begin() + m_referenceOffsets[row],
+                                 m_references.begin() + m_referenceOffsets[row + 1]);
+}
+
+const std::vector<std::string> &CommitTable::scopes() const
+{
+    return m_scopes;
+}
+
+uint8_t CommitTable::combinedFlags() const
+{
+    uint8_t flags = 0;
+    for (const uint8_t row : m_flags) {
+        flags |= row;
+    }
+    return flags;
+}
+
+CommitTable::Groups CommitTable::groupByType() const
+{
+    Groups groups;
+    uint32_t counts[MaxTypes] = {};
+
+    for (const Type type : m_types) {
+        counts[type]++;
+    }
+
+    groups.begin[0] = 0;
+    for (int i = 0; i < MaxTypes; i++) {
+        groups.begin[i + 1] = groups.begin[i] + counts[i];
+    }
+
+    uint32_t next[MaxTypes];
+    std::copy(groups.begin, groups.begin + MaxTypes, next);
+
+    groups.rows.resize(m_types.size());
+    for (uint32_t row = 0; row < m_types.size(); row++) {
+        groups.rows[next[m_types[row]]++] = row;
+    }
+
+    return groups;
+}
+
+void CommitTable::sortByScope(std::vector<uint32_t> &rows) const
+{
+    // Rank the distinct scopes by name; the empty scope (id 0) ranks first.
+    std::vector<uint32_t> order(m_scopes.size());
+    for (uint32_t id = 0; id < order.size(); id++) {
+        order[id] = id;
+    }
+    std::sort(order.begin(), order.end(),
+              [this](uint32_t a, uint32_t b) { return m_scopes[a] < m_scopes[b]; });
+
+    std::vector<uint32_t> rank(m_scopes.size());
+    for (uint32_t i = 0; i < order.size(); i++) {
+        rank[order[i]] = i;
+    }
+
+    std::vector<uint32_t> next(m_scopes.size() + 1, 0);
+    for (const uint32_t row : rows) {
+        next[rank[scopeId(row)] + 1]++;
+    }
+    for (size_t i = 1; i < next.size(); i++) {
+        next[i] += next[i - 1];
+    }
+
+    std::vector<uint32_t> sorted(rows.size());
+    for (const uint32_t row : rows) {
+        sorted[next[rank[scopeId(row)]]++] = row;
+    }
+    rows = std::move(sorted);
+}
+
+CommitTable::Span CommitTable::store(std::string_view text)
+{
+    const Span span { static_cast<uint32_t>(m_text.size()), static_cast<uint32_t>(text.size()) };
+    m_text.append(text);
+    return span;
+}
+
+// Intern each scope of a comma-separated list and store the list as `a, b`.
+CommitTable::Span CommitTable::storeScopes(std::string_view scope)
+{
+    const auto offset = static_cast<uint32_t>(m_text.size());
+
+    while (!scope.empty()) {
+        const size_t comma = scope.find(',');
+        auto part = scope.substr(0, comma);
+        scope = comma == std::string_view::npos ? std::string_view() : scope.substr(comma + 1);
+
+        const size_t first = part.find_first_not_of(' ');
+        if (first == std::string_view::npos) {
+            continue;
+        }
+        part = part.substr(first, part.find_last_not_of(' ') - first + 1);
+
+        if (m_text.size() > offset) {
+            m_text.append(", ");
+        }
+        m_text.append(part);
+        m_scopeIds.push_back(intern(part));
+    }
+    m_scopeOffsets.push_back(static_cast<uint32_t>(m_scopeIds.size()));
+
+    return Span { offset, static_cast<uint32_t>(m_text.size()) - offset };
+}
+
+uint32_t CommitTable::intern(std::string_view scope)
+{
+    if (scope.empty()) {
+        return 0;
+    }
+
+    const auto it = m_scopeIndex.find(std::string(scope));
+    if (it != m_scopeIndex.end()) {
+        return it->second;
+    }
+
+    const auto id = static_cast<uint32_t>(m_scopes.size());
+    m_scopes.emplace_back(scope);
+    m_scopeIndex.emplace(m_scopes.back(), id);
+    return id;
+}
@@ -0,0 +1,163 @@
+/**
+ * @file "standard-release/commits/table.h"
+ * @brief Column store of parsed conventional commits.
+ */
+#pragma once
+
+#include "standard-release/global/global.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace StandardRelease {
+
+/**
+ * @brief Parsed conventional commits, one array per field.
+ * @details Each commit is a row: a one-byte type, a byte of flags, interned scope ids, the issue
+ * and pull request numbers it refers to, and the scope, subject and hash as spans of one shared
+ * text buffer. Computing the next version is an OR over the flags column, and grouping rows by type
+ * or scope for the changelog is a counting sort over an id column; neither compares the text of the
+ * rows.
+ */
+class STANDARDRELEASE_EXPORT CommitTable
+{
+public:
+    /**
+     * @brief Type ids of the standard commit types.
+     * @details A configured CommitTypes may add more ids after these, up to MaxTypes.
+     */
+    enum Type : uint8_t
+    {
+        Build,
+        Ci,
+        Chore,
+        Docs,
+        Feat,
+        Fix,
+        Perf,
+        Refactor,
+        Revert,
+        Style,
+        Test,
+        TypeCount,
+    };
+
+    /** Number of type ids. */
+    static const int MaxTypes = 64;
+
+    /** Bits of flags(). */
+    enum Flag : uint8_t
+    {
+        Breaking = 1 << 0,
+        Feature = 1 << 1,
+        Bugfix = 1 << 2,
+    };
+
+    /** Rows ordered by type (see groupByType()). */
+    struct Groups
+    {
+        /** Row indices, ordered by type and then by row. */
+        std::vector<uint32_t> rows;
+        /** Rows of type `t` are `rows[begin[t]]` up to (excluding) `rows[begin[t + 1]]`. */
+        uint32_t begin[MaxTypes + 1];
+
+        /** Number of rows of a type. */
+        uint32_t count(uint8_t type) const
+        {
+            return begin[type + 1] - begin[type];
+        }
+    };
+
+    CommitTable();
+
+    /** Reserve space for a number of commits. */
+    void reserve(size_t rows);
+
+    /**
+     * @brief Add a commit.
+     * @param scope Comma-separated scopes (e.g. `core, git/refs`); may be empty.
+     * @param references Issue and pull request numbers (see findReferences()).
+     * @returns The row.
+     */
+    size_t append(Type type, std::string_view scope, std::string_view subject,
+                  std::string_view hash = "", uint8_t flags = 0,
+                  const std::vector<uint32_t> &references = {});
+
+    /** Reverse the order of the rows. */
+    void reverse();
+
+    /** Remove every commit. */
+    void clear();
+
+    /** Number of commits. */
+    size_t size() const;
+
+    /** Are there no commits? */
+    bool empty() const;
+
+    Type type(size_t row) const;
+    uint8_t flags(size_t row) const;
+    /** Number of scopes of a commit. */
+    size_t scopeCount(size_t row) const;
+    /** Interned id of one scope of a commit; 0 (the empty scope) if it has fewer scopes. */
+    uint32_t scopeId(size_t row, size_t index = 0) const;
+    /** Every scope of a commit, separated by `, `. */
+    std::string_view scope(size_t row) const;
+    std::string_view subject(size_t row) const;
+    std::string_view hash(size_t row) const;
+    /** Number of issues and pull requests a commit refers to. */
+    size_t referenceCount(size_t row) const;
+    /** Issue or pull request number a commit refers to. */
+    uint32_t reference(size_t row, size_t index) const;
+    /** Every issue and pull request number a commit refers to. */
+    std::vector<uint32_t> references(size_t row) const;
+
+    /** Every distinct scope, indexed by scope id; id 0 is the empty scope. */
+    const std::vector<std::string> &scopes() const;
+
+    /** Flags of every commit OR'ed together. */
+    uint8_t combinedFlags() const;
+
+    /** Stable counting sort of the rows by type. */
+    Groups groupByType() const;
+
+    /**
+     * @brief Stable counting sort of some rows by the name of their first scope.
+     * @details Rows without a scope come first. Only the distinct scopes are compared by name.
+     */
+    void sortByScope(std::vector<uint32_t> &rows) const;
+
+private:
+    struct Span
+    {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    Span store(std::string_view text);
+    Span storeScopes(std::string_view scope);
+    uint32_t intern(std::string_view scope);
+
+    std::vector<Type> m_types;
+    std::vector<uint8_t> m_flags;
+    std::vector<Span> m_scopeLabels;
+    std::vector<Span> m_subjects;
+    std::vector<Span> m_hashes;
+    std::string m_text;
+
+    /** Scope ids of row `r` are `m_scopeIds[m_scopeOffsets[r]]` to `m_scopeOffsets[r + 1]`. */
+    std::vector<uint32_t> m_scopeOffsets;
+    std::vector<uint32_t> m_scopeIds;
+
+    /** References of row `r` are `m_references[m_referenceOffsets[r]]` to `[r + 1]`. */
+    std::vector<uint32_t> m_referenceOffsets;
+    std::vector<uint32_t> m_references;
+
+    std::vector<std::string> m_scopes;
+    std::unordered_map<std::string, uint32_t> m_scopeIndex;
+};
+
+}
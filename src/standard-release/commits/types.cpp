@@ -0,0 +1,154 @@
+#include "types.h"
+#include <algorithm>
+
+using namespace StandardRelease;
+
+static const uint8_t EmptySlot = 0xff;
+
+// FNV-1a with the seed folded into the offset basis.
+static uint64_t hash(std::string_view name, uint64_t seed)
+{
+    uint64_t h = 14695981039346656037ull ^ (seed * 0x9e3779b97f4a7c15ull);
+    for (const char c : name) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+CommitTypes::CommitTypes()
+    : m_types {
+        { "build", "", NoBump },
+        { "ci", "", NoBump },
+        { "chore", "", NoBump },
+        { "docs", "", NoBump },
+        { "feat", "Features", Minor },
+        { "fix", "Bug Fixes", Patch },
+        { "perf", "Performance Improvements", NoBump },
+        { "refactor", "", NoBump },
+        { "revert", "Reverts", NoBump },
+        { "style", "", NoBump },
+        { "test", "", NoBump },
+    }
+    , m_sections { "Features", "Bug Fixes", "Performance Improvements", "Reverts" }
+    , m_seed(0)
+{
+    compile();
+}
+
+const CommitTypes &CommitTypes::defaults()
+{
+    static const CommitTypes types;
+    return types;
+}
+
+bool CommitTypes::bumpFromName(std::string_view name, Bump &bump)
+{
+    static const std::string_view names[] = { "none", "patch", "minor", "major" };
+    for (int i = 0; i <= Major; i++) {
+        if (names[i] == name) {
+            bump = static_cast<Bump>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CommitTypes::set(const std::string &name, const std::string &section, Bump bump)
+{
+    if (!section.empty()
+        && std::find(m_sections.begin(), m_sections.end(), section) == m_sections.end()) {
+        m_sections.push_back(section);
+    }
+
+    const int id = find(name);
+    if (id >= 0) {
+        m_types[id].section = section;
+        m_types[id].bump = bump;
+        return true;
+    }
+    if (m_types.size() == CommitTable::MaxTypes) {
+        return false;
+    }
+
+    m_types.push_back({ name, section, bump });
+    compile();
+    return true;
+}
+
+size_t CommitTypes::size() const
+{
+    return m_types.size();
+}
+
+const CommitTypes::Type &CommitTypes::type(uint8_t id) const
+{
+    return m_types[id];
+}
+
+int CommitTypes::find(std::string_view name) const
+{
+    const uint8_t id = m_slots[slot(name)];
+    return id != EmptySlot && m_types[id].name == name ? id : -1;
+}
+
+uint8_t CommitTypes::flags(uint8_t id) const
+{
+    switch (m_types[id].bump) {
+        case Major:
+            return CommitTable::Breaking;
+        case Minor:
+            return CommitTable::Feature;
+        case Patch:
+            return CommitTable::Bugfix;
+        default:
+            return 0;
+    }
+}
+
+std::vector<std::string> CommitTypes::sections() const
+{
+    std::vector<std::string> titles;
+    for (const auto &title : m_sections) {
+        const bool used = std::any_of(m_types.begin(), m_types.end(),
+                                      [&title](const Type &type) { return type.section == title; });
+        if (used) {
+            titles.push_back(title);
+        }
+    }
+    return titles;
+}
+
+// Try seeds until every name lands in its own slot, doubling the table now and then. With at
+// most 64 names in at least twice as many slots this takes a handful of attempts.
+void CommitTypes::compile()
+{
+    size_t size = 16;
+    while (size < m_types.size() * 2) {
+        size *= 2;
+    }
+
+    for (uint64_t seed = 0;; seed++) {
+        if (seed > 0 && seed % 64 == 0) {
+            size *= 2;
+        }
+
+        m_seed = seed;
+        m_slots.assign(size, EmptySlot);
+
+        bool collision = false;
+        for (size_t id = 0; id < m_types.size() && !collision; id++) {
+            auto &entry = m_slots[slot(m_types[id].name)];
+            collision = entry != EmptySlot;
+            entry = static_cast<uint8_t>(id);
+        }
+        if (!collision) {
+            return;
+        }
+    }
+}
+
+size_t CommitTypes::slot(std::string_view name) const
+{
+    return hash(name, m_seed) & (m_slots.size() - 1);
+}
@@ -0,0 +1,85 @@
+/**
+ * @file "standard-release/commits/types.h"
+ * @brief Commit types, their changelog sections and version bumps.
+ */
+#pragma once
+
+#include "standard-release/commits/table.h"
+#include "standard-release/global/global.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace StandardRelease {
+
+/**
+ * @brief The commit types a project accepts.
+ * @details Starts with the types of the [Conventional Commits](https://conventionalcommits.org/)
+ * standard, in the order of CommitTable::Type, and can be extended or overridden (the `types` key
+ * of the config file). Every change recompiles a perfect hash of the names, so find() costs one
+ * hash and one string comparison however many types there are.
+ */
+class STANDARDRELEASE_EXPORT CommitTypes
+{
+public:
+    /** Version bump caused by a commit of a type. */
+    enum Bump : uint8_t
+    {
+        NoBump,
+        Patch,
+        Minor,
+        Major,
+    };
+
+    struct Type
+    {
+        std::string name;
+        /** Changelog section title; empty if commits of this type are left out. */
+        std::string section;
+        Bump bump;
+    };
+
+    /** The standard types: `feat`, `fix`, `perf` and `revert` have sections. */
+    CommitTypes();
+
+    /** Shared instance of the standard types. */
+    static const CommitTypes &defaults();
+
+    /** Bump with a name (`none`, `patch`, `minor` or `major`). */
+    static bool bumpFromName(std::string_view name, Bump &bump);
+
+    /**
+     * @brief Add a type, or change an existing one.
+     * @returns `false` if there already are CommitTable::MaxTypes types.
+     */
+    bool set(const std::string &name, const std::string &section, Bump bump);
+
+    /** Number of types. */
+    size_t size() const;
+
+    /** Type with an id (ids are CommitTable type ids). */
+    const Type &type(uint8_t id) const;
+
+    /** Id of the type with a name, or -1 if there is none. */
+    int find(std::string_view name) const;
+
+    /** CommitTable flags for a commit of a type. */
+    uint8_t flags(uint8_t id) const;
+
+    /** Section titles in use: the standard ones, then others in the order they were set. */
+    std::vector<std::string> sections() const;
+
+private:
+    void compile();
+    size_t slot(std::string_view name) const;
+
+    std::vector<Type> m_types;
+    /** Every section title ever set, in order. */
+    std::vector<std::string> m_sections;
+    /** Type id per hash slot; 0xff if empty. */
+    std::vector<uint8_t> m_slots;
+    uint64_t m_seed;
+};
+
+}
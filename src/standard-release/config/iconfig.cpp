@@ -6,6 +6,7 @@ struct StandardRelease::IConfigPrivate
 {
     Error error;
     std::map<std::string, std::string> data;
+    CommitTypes types;
 
     IConfigPrivate()
         : data()
@@ -19,6 +20,22 @@ IConfig::IConfig()
 {
 }
 
+IConfig::IConfig(const IConfig &other)
+    : d(new IConfigPrivate(*other.d))
+{
+}
+
+IConfig &IConfig::operator=(const IConfig &other)
+{
+    *d = *other.d;
+    return *this;
+}
+
+IConfig::~IConfig()
+{
+    delete d;
+}
+
 void IConfig::setError(const Error error)
 {
     d->error = error;
@@ -34,6 +51,16 @@ void IConfig::setData(const std::map<std::string, std::string> data)
     d->data = data;
 }
 
+void IConfig::setCommitTypes(const CommitTypes &types)
+{
+    d->types = types;
+}
+
+const CommitTypes &IConfig::commitTypes() const
+{
+    return d->types;
+}
+
 std::string IConfig::operator[](const std::string key)
 {
     return value(key);
@@ -41,12 +68,12 @@ std::string IConfig::operator[](const std::string key)
 
 std::string IConfig::value(const std::string &key) const
 {
-    const int count = d->data.count(key);
-    std::string ret = "";
-    if (count != 0) {
-        ret = d->data[key];
+    // find() rather than operator[], which may insert: batch lanes share one config.
+    const auto it = d->data.find(key);
+    if (it == d->data.end()) {
+        return "";
     }
-    return ret;
+    return it->second;
 }
 
 std::vector<std::string> IConfig::keys() const
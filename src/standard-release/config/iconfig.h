@@ -22,6 +22,12 @@ class IConfigPrivate;
 class STANDARDRELEASE_EXPORT IConfig
 {
 public:
+    virtual ~IConfig();
+
+    /** Copies are independent of the original. */
+    IConfig(const IConfig &other);
+    IConfig &operator=(const IConfig &other);
+
     /** Subscript operator. */
     std::string operator[](const std::string key);
 
@@ -30,6 +36,9 @@ public:
 
     std::string value(const std::string &key) const;
 
+    /** Commit types, with any from the `types` key. */
+    const CommitTypes &commitTypes() const;
+
     /** Current status. */
     Error error() const;
 
@@ -47,6 +56,8 @@ protected:
 
     void setData(const std::map<std::string, std::string> data);
 
+    void setCommitTypes(const CommitTypes &types);
+
 private:
     IConfigPrivate *d;
 };
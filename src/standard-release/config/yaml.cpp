@@ -19,6 +19,36 @@ std::string MISSING_REQUIRED_KEY(const std::string &key, const std::string &file
     return "Missing required '" + key + "' in " + file;
 }
 
+// `types` is a list of `{ type, section, bump }`; entries for standard types override them.
+static CommitTypes parseTypes(const YAML::Node &node, const std::string &file)
+{
+    CommitTypes types;
+
+    if (!node.IsSequence()) {
+        throw Exception("'types' must be a list in " + file);
+    }
+
+    for (const auto &entry : node) {
+        if (!entry.IsMap() || !entry["type"]) {
+            throw Exception(MISSING_REQUIRED_KEY("type", file));
+        }
+
+        const auto name = entry["type"].as<std::string>();
+        const auto section = entry["section"] ? entry["section"].as<std::string>() : "";
+
+        CommitTypes::Bump bump = CommitTypes::NoBump;
+        if (entry["bump"] && !CommitTypes::bumpFromName(entry["bump"].as<std::string>(), bump)) {
+            throw Exception("Invalid bump for type '" + name + "' in " + file);
+        }
+
+        if (!types.set(name, section, bump)) {
+            throw Exception("Too many commit types in " + file);
+        }
+    }
+
+    return types;
+}
+
 YamlConfig YamlConfig::parse(const std::string &file)
 {
     YamlConfig config(file);
@@ -43,6 +73,24 @@ YamlConfig::YamlConfig(const std::string &fileName)
     d->fileName = fileName;
 }
 
+YamlConfig::YamlConfig(const YamlConfig &other)
+    : IConfig(other)
+    , d(new YamlConfigPrivate(*other.d))
+{
+}
+
+YamlConfig &YamlConfig::operator=(const YamlConfig &other)
+{
+    IConfig::operator=(other);
+    *d = *other.d;
+    return *this;
+}
+
+YamlConfig::~YamlConfig()
+{
+    delete d;
+}
+
 std::string YamlConfig::filename() const
 {
     return d->fileName;
@@ -76,8 +124,12 @@ bool YamlConfig::parse()
 
     for (YAML::const_iterator it = node.begin(); it != node.end(); ++it) {
         auto key = it->first.as<std::string>();
-        auto value = it->second.as<std::string>();
-        data[key] = value;
+        if (key == "types") {
+            setCommitTypes(parseTypes(it->second, filename()));
+        } else if (it->second.IsScalar()) {
+            data[key] = it->second.as<std::string>();
+        }
+        // Other lists and maps are reserved for future options.
     }
 
     setData(data);
@@ -26,6 +26,12 @@ public:
     /** Create a new instance from a config file. */
     YamlConfig(const std::string &fileName);
 
+    ~YamlConfig();
+
+    /** Copies are independent of the original. */
+    YamlConfig(const YamlConfig &other);
+    YamlConfig &operator=(const YamlConfig &other);
+
     /**
      * @brief Returns the current config filename.
      * @returns The current path to the YAML config file.
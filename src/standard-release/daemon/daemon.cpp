@@ -0,0 +1,588 @@
+#include "daemon.h"
+#include "standard-release/changelog/changelog.h"
+#include "standard-release/commits/conventional.h"
+#include "standard-release/config/yaml.h"
+#include "standard-release/errors/error.h"
+#include "standard-release/git/repository.h"
+#include "standard-release/log/ilog.h"
+#include "standard-release/sources/json.h"
+#include "standard-release/sources/text.h"
+#include "standard-release/trace/trace.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <memory>
+#include <poll.h>
+#include <sstream>
+#include <sys/inotify.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <system_error>
+#include <unistd.h>
+#include <unordered_map>
+
+using namespace StandardRelease;
+
+namespace {
+
+/** A watched repository and its precomputed release. */
+struct WatchedRepository
+{
+    std::string dirName;
+    IConfig *config = nullptr;
+    ISource *versionFile = nullptr;
+    GitRepository repo;
+    ConventionalCommits commits;
+    Changelog changelog;
+    /** Refs changed since the last refresh. */
+    bool dirty = false;
+    std::string current;
+    std::string next;
+    std::string entry;
+    /** Why the last reload failed; the preview is not served until one succeeds. */
+    std::string failure;
+
+    ~WatchedRepository()
+    {
+        delete config;
+        delete versionFile;
+    }
+};
+
+/** Directory with an inotify watch. */
+struct Watch
+{
+    size_t repository;
+    std::filesystem::path dir;
+    /** The `.git` directory itself, where only `HEAD` and `packed-refs` matter. */
+    bool gitDir;
+};
+
+struct Client
+{
+    int fd;
+    std::string input;
+};
+
+}
+
+struct StandardRelease::DaemonPrivate
+{
+    Error error;
+    std::vector<std::unique_ptr<WatchedRepository>> repositories;
+    /** Watched repository by directory, as given and canonical. */
+    std::unordered_map<std::string, size_t> names;
+    std::unordered_map<int, Watch> watches;
+    std::vector<Client> clients;
+    std::filesystem::path socketPath;
+    int inotifyFd = -1;
+    int listenFd = -1;
+    /** stop() writes to wakeFds[1] to interrupt poll(). */
+    int wakeFds[2] = { -1, -1 };
+
+    void watch(size_t repository, const std::filesystem::path &dir, bool gitDir);
+    void watchTree(size_t repository, const std::filesystem::path &dir);
+    void readEvents();
+    bool load(WatchedRepository &watched);
+    void render(WatchedRepository &watched);
+    void update(WatchedRepository &watched);
+    const WatchedRepository *find(const std::string &name) const;
+    std::string answer(const std::string &request) const;
+    bool serve(Client &client);
+};
+
+static const uint32_t WATCH_EVENTS
+        = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE | IN_MOVED_FROM;
+
+/** Longest request line; a client that sends more without a newline is dropped. */
+static const size_t MAX_REQUEST = 4096;
+
+static std::string reply(const std::string &payload)
+{
+    return "OK " + std::to_string(payload.size()) + "\n" + payload;
+}
+
+static std::string fail(const std::string &message)
+{
+    return "ERR " + message + "\n";
+}
+
+static bool endsWith(const std::string &str, const std::string &suffix)
+{
+    return str.size() >= suffix.size()
+            && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+void DaemonPrivate::watch(size_t repository, const std::filesystem::path &dir, bool gitDir)
+{
+    const int wd = inotify_add_watch(inotifyFd, dir.c_str(), WATCH_EVENTS);
+    if (wd < 0) {
+        srWarning(lcDaemon()) << "cannot watch " << dir.string() << ": " << std::strerror(errno);
+        return;
+    }
+    watches[wd] = Watch { repository, dir, gitDir };
+}
+
+// inotify is not recursive; every directory under refs/ gets its own watch.
+void DaemonPrivate::watchTree(size_t repository, const std::filesystem::path &dir)
+{
+    std::error_code code;
+
+    watch(repository, dir, false);
+    for (auto it = std::filesystem::recursive_directory_iterator(dir, code);
+         it != std::filesystem::recursive_directory_iterator(); it.increment(code)) {
+        if (code) {
+            break;
+        }
+        if (it->is_directory(code)) {
+            watch(repository, it->path(), false);
+        }
+    }
+}
+
+// Mark the repositories whose refs changed.
+void DaemonPrivate::readEvents()
+{
+    alignas(inotify_event) char buffer[16384];
+
+    while (true) {
+        const ssize_t length = ::read(inotifyFd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            break;
+        }
+
+        for (ssize_t offset = 0; offset < length;) {
+            const auto *event = reinterpret_cast<const inotify_event *>(buffer + offset);
+            offset += sizeof(inotify_event) + event->len;
+
+            const auto it = watches.find(event->wd);
+            if (it == watches.end()) {
+                continue;
+            }
+            if (event->mask & IN_IGNORED) {
+                watches.erase(it);
+                continue;
+            }
+
+            const std::string name = event->len > 0 ? event->name : "";
+            const Watch &watch = it->second;
+
+            if ((event->mask & IN_ISDIR) && (event->mask & IN_CREATE) && !watch.gitDir) {
+                watchTree(watch.repository, watch.dir / name);
+                continue;
+            }
+
+            // Refs are written to `<name>.lock` and renamed into place.
+            if (endsWith(name, ".lock")) {
+                continue;
+            }
+            if (watch.gitDir && name != "HEAD" && name != "packed-refs") {
+                continue;
+            }
+
+            repositories[watch.repository]->dirty = true;
+        }
+    }
+}
+
+bool DaemonPrivate::load(WatchedRepository &watched)
+{
+    TraceSpan span("daemon-load", "daemon");
+
+    watched.versionFile->detect(watched.dirName);
+    if (watched.versionFile->error()) {
+        error = Error(Error::NoVersionFile, watched.dirName);
+        return false;
+    }
+
+    // A missing `origin` only leaves the changelog links empty.
+    if (!watched.repo.parse(watched.versionFile->version())) {
+        error = watched.repo.error();
+        return false;
+    }
+    watched.commits.parseCommits(watched.repo.commits());
+    if (watched.commits.error()) {
+        error = watched.commits.error();
+        return false;
+    }
+
+    render(watched);
+    watched.failure.clear();
+    return true;
+}
+
+void DaemonPrivate::render(WatchedRepository &watched)
+{
+    SemVer current = watched.versionFile->version();
+
+    watched.commits.setVersion(current);
+    watched.commits.bump();
+
+    SemVer next = watched.commits.version();
+    watched.current = current.str();
+    watched.next = next.str();
+    watched.entry = next == current ? std::string()
+                                    : watched.changelog.renderRelease(next, current,
+                                                                      watched.commits.table(),
+                                                                      watched.repo.url());
+}
+
+void DaemonPrivate::update(WatchedRepository &watched)
+{
+    TraceSpan span("daemon-update", "daemon");
+    GitRepository::Commits added;
+
+    watched.dirty = false;
+
+    if (watched.repo.update(added)) {
+        if (added.empty()) {
+            return;
+        }
+        if (watched.commits.appendCommits(added)) {
+            srInfo(lcDaemon()) << watched.dirName << ": " << added.size() << " new commits";
+            render(watched);
+            return;
+        }
+    }
+
+    // History was rewritten, or the new commits change earlier entries (e.g. a release).
+    srInfo(lcDaemon()) << watched.dirName << ": reloading";
+    if (!load(watched)) {
+        watched.failure = error.message();
+        srWarning(lcDaemon()) << watched.dirName << ": " << watched.failure;
+    }
+}
+
+const WatchedRepository *DaemonPrivate::find(const std::string &name) const
+{
+    if (name.empty()) {
+        return repositories.size() == 1 ? repositories.front().get() : nullptr;
+    }
+
+    auto it = names.find(name);
+    if (it == names.end()) {
+        std::error_code code;
+        it = names.find(std::filesystem::weakly_canonical(name, code).string());
+    }
+    return it == names.end() ? nullptr : repositories[it->second].get();
+}
+
+std::string DaemonPrivate::answer(const std::string &request) const
+{
+    std::istringstream in(request);
+    std::string command;
+    std::string name;
+    in >> command >> name;
+
+    if (command == "repos") {
+        std::string list;
+        for (const auto &watched : repositories) {
+            list += watched->dirName + "\n";
+        }
+        return reply(list);
+    }
+
+    if (command != "version" && command != "current" && command != "changelog") {
+        return fail("unknown request '" + command + "'");
+    }
+
+    const WatchedRepository *watched = find(name);
+    if (watched == nullptr) {
+        return fail(name.empty() ? "no repository given" : "unknown repository " + name);
+    }
+    if (!watched->failure.empty()) {
+        return fail(watched->dirName + ": " + watched->failure);
+    }
+
+    if (command == "version") {
+        return reply(watched->next + "\n");
+    } else if (command == "current") {
+        return reply(watched->current + "\n");
+    }
+    return reply(watched->entry);
+}
+
+// Answer every complete request a client has sent. Returns `false` once the client is gone or
+// its unfinished request is longer than MAX_REQUEST.
+bool DaemonPrivate::serve(Client &client)
+{
+    char buffer[4096];
+    const ssize_t length = ::recv(client.fd, buffer, sizeof(buffer), 0);
+    if (length <= 0) {
+        return false;
+    }
+    client.input.append(buffer, length);
+
+    size_t begin = 0;
+    size_t end;
+    while ((end = client.input.find('\n', begin)) != std::string::npos) {
+        std::string request = client.input.substr(begin, end - begin);
+        if (!request.empty() && request.back() == '\r') {
+            request.pop_back();
+        }
+        begin = end + 1;
+
+        const std::string response = answer(request);
+        for (size_t sent = 0; sent < response.size();) {
+            const ssize_t n = ::send(client.fd, response.data() + sent, response.size() - sent,
+                                     MSG_NOSIGNAL);
+            if (n <= 0) {
+                return false;
+            }
+            sent += n;
+        }
+    }
+    client.input.erase(0, begin);
+
+    return client.input.size() <= MAX_REQUEST;
+}
+
+Daemon::Daemon()
+    : d(new DaemonPrivate)
+{
+    d->inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (d->inotifyFd < 0) {
+        d->error = Error(Error::WatchFailed, std::strerror(errno));
+    }
+    if (pipe2(d->wakeFds, O_NONBLOCK | O_CLOEXEC) != 0) {
+        d->wakeFds[0] = d->wakeFds[1] = -1;
+    }
+}
+
+Daemon::~Daemon()
+{
+    for (const auto &client : d->clients) {
+        ::close(client.fd);
+    }
+    if (d->listenFd >= 0) {
+        ::close(d->listenFd);
+        std::error_code code;
+        std::filesystem::remove(d->socketPath, code);
+    }
+    if (d->inotifyFd >= 0) {
+        ::close(d->inotifyFd);
+    }
+    for (const int fd : d->wakeFds) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+    delete d;
+}
+
+Error Daemon::error() const
+{
+    return d->error;
+}
+
+bool Daemon::addRepository(const std::string &dirName, const std::string &configFile)
+{
+    TraceSpan span("daemon-add", "daemon");
+    std::error_code code;
+
+    if (d->inotifyFd < 0) {
+        d->error = Error(Error::WatchFailed, "inotify is not available");
+        return false;
+    }
+
+    std::string fileName = configFile;
+    for (const auto name : { "release.yml", ".release.yml" }) {
+        if (fileName.empty() && std::filesystem::exists(std::filesystem::path(dirName) / name,
+                                                        code)) {
+            fileName = (std::filesystem::path(dirName) / name).string();
+        }
+    }
+    if (fileName.empty() || !std::filesystem::exists(fileName, code)) {
+        d->error = Error(Error::ConfigFileNotFound, dirName);
+        return false;
+    }
+
+    auto watched = std::make_unique<WatchedRepository>();
+    watched->dirName = dirName;
+
+    try {
+        watched->config = new YamlConfig(fileName);
+        watched->config->parse();
+    } catch (const Exception &e) {
+        d->error = Error(Error::ConfigFileInvalid, e.what());
+        return false;
+    }
+
+    const IConfig &config = *watched->config;
+    const auto releaseType = config.value("releaseType");
+    if (releaseType == "node") {
+        watched->versionFile = new JsonFile();
+    } else if (releaseType == "text") {
+        watched->versionFile = new StandardRelease::TextFile();
+    } else {
+        d->error = Error(Error::ConfigFileInvalid, "Unrecognized project type " + releaseType);
+        return false;
+    }
+
+    GitRepository::WalkMode walkMode;
+    if (!GitRepository::walkModeFromName(config.value("walk"), walkMode)) {
+        d->error = Error(Error::ConfigFileInvalid,
+                         "Unrecognized walk mode " + config.value("walk"));
+        return false;
+    }
+
+    if (!watched->repo.open(dirName)) {
+        d->error = watched->repo.error();
+        return false;
+    }
+    watched->repo.setWalkMode(walkMode);
+    watched->repo.setPathFilter(config.value("path"));
+    watched->repo.setPathIndex(config.value("pathIndex") == "true");
+    watched->repo.setDetectDuplicates(config.value("detectDuplicates") == "true");
+
+    watched->commits.setTypes(config.commitTypes());
+    watched->commits.setExpandSquashes(config.value("expandSquashes") == "true");
+    watched->changelog.setTypes(config.commitTypes());
+    watched->changelog.setGroupByScope(config.value("groupByScope") == "true");
+
+    if (!d->load(*watched)) {
+        return false;
+    }
+
+    const size_t index = d->repositories.size();
+    const auto gitDir = std::filesystem::path(dirName) / ".git";
+    d->watch(index, gitDir, true);
+    d->watchTree(index, gitDir / "refs");
+
+    d->names[dirName] = index;
+    d->names[std::filesystem::weakly_canonical(dirName, code).string()] = index;
+    srInfo(lcDaemon()) << dirName << ": " << watched->current << " -> " << watched->next;
+    d->repositories.push_back(std::move(watched));
+
+    d->error = Error::Success;
+    return true;
+}
+
+std::vector<std::string> Daemon::repositories() const
+{
+    std::vector<std::string> dirNames;
+    for (const auto &watched : d->repositories) {
+        dirNames.push_back(watched->dirName);
+    }
+    return dirNames;
+}
+
+bool Daemon::listen(const std::filesystem::path &socketPath)
+{
+    sockaddr_un address {};
+    std::error_code code;
+
+    if (socketPath.string().size() >= sizeof(address.sun_path)) {
+        d->error = Error(Error::SocketFailed, "path too long: " + socketPath.string());
+        return false;
+    }
+
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (fd < 0) {
+        d->error = Error(Error::SocketFailed, std::strerror(errno));
+        return false;
+    }
+
+    if (socketPath.has_parent_path()) {
+        std::filesystem::create_directories(socketPath.parent_path(), code);
+    }
+    std::filesystem::remove(socketPath, code);
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    if (::bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0
+        || ::listen(fd, SOMAXCONN) != 0) {
+        d->error = Error(Error::SocketFailed, socketPath.string() + ": " + std::strerror(errno));
+        ::close(fd);
+        return false;
+    }
+
+    d->listenFd = fd;
+    d->socketPath = socketPath;
+    srInfo(lcDaemon()) << "listening on " << socketPath.string();
+
+    d->error = Error::Success;
+    return true;
+}
+
+std::string Daemon::query(const std::string &request) const
+{
+    return d->answer(request);
+}
+
+void Daemon::refresh()
+{
+    d->readEvents();
+    for (auto &watched : d->repositories) {
+        if (watched->dirty) {
+            d->update(*watched);
+        }
+    }
+}
+
+bool Daemon::run()
+{
+    std::vector<pollfd> fds;
+
+    while (true) {
+        fds.clear();
+        fds.push_back({ d->wakeFds[0], POLLIN, 0 });
+        fds.push_back({ d->inotifyFd, POLLIN, 0 });
+        fds.push_back({ d->listenFd, POLLIN, 0 });
+        for (const auto &client : d->clients) {
+            fds.push_back({ client.fd, POLLIN, 0 });
+        }
+
+        if (::poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            d->error = Error(Error::InternalError, std::strerror(errno));
+            return false;
+        }
+
+        if (fds[0].revents & POLLIN) {
+            char byte;
+            while (::read(d->wakeFds[0], &byte, 1) > 0) {
+            }
+            break;
+        }
+
+        if (fds[1].revents & POLLIN) {
+            refresh();
+        }
+
+        // Clients are served before new ones are accepted, so `fds` still lines up.
+        for (size_t i = d->clients.size(); i > 0; i--) {
+            const auto revents = fds[2 + i].revents;
+            if (revents == 0) {
+                continue;
+            }
+            if (!(revents & POLLIN) || !d->serve(d->clients[i - 1])) {
+                ::close(d->clients[i - 1].fd);
+                d->clients.erase(d->clients.begin() + (i - 1));
+            }
+        }
+
+        if (fds[2].revents & POLLIN) {
+            int fd;
+            while ((fd = ::accept4(d->listenFd, nullptr, nullptr, SOCK_CLOEXEC)) >= 0) {
+                // A client that stops reading must not stall every other query.
+                const timeval timeout { 1, 0 };
+                ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+                d->clients.push_back({ fd, std::string() });
+            }
+        }
+    }
+
+    return true;
+}
+
+void Daemon::stop()
+{
+    const char byte = 0;
+    if (d->wakeFds[1] >= 0) {
+        [[maybe_unused]] const ssize_t ret = ::write(d->wakeFds[1], &byte, 1);
+    }
+}
@@ -0,0 +1,93 @@
+/**
+ * @file "standard-release/daemon/daemon.h"
+ * @brief Service that keeps the next release of repositories precomputed.
+ */
+#pragma once
+
+#include "standard-release/errors/errors.h"
+#include "standard-release/global/global.h"
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace StandardRelease {
+
+class DaemonPrivate;
+
+/**
+ * @brief Keeps the next version and changelog entry of repositories up to date.
+ * @details Every repository stays open. `HEAD`, `packed-refs` and everything under `.git/refs`
+ * are watched with inotify; when they change, only the new commits are read and parsed (see
+ * GitRepository::update() and ConventionalCommits::appendCommits()) and the preview is
+ * rendered again. Queries over a Unix socket are answered from the stored preview.
+ *
+ * Requests are one line each:
+ *  - `version [repo]`: the next version.
+ *  - `current [repo]`: the current version.
+ *  - `changelog [repo]`: the changelog entry of the next release.
+ *  - `repos`: every watched repository, one per line.
+ *
+ * `repo` may be left out if only one repository is watched. Replies are `OK <length>` and a
+ * newline followed by `length` bytes, or `ERR <message>` and a newline. A client whose request
+ * line grows past 4 KiB is disconnected.
+ *
+ * Only available on Linux.
+ */
+class STANDARDRELEASE_EXPORT Daemon
+{
+public:
+    Daemon();
+    ~Daemon();
+
+    Daemon(const Daemon &) = delete;
+    Daemon &operator=(const Daemon &) = delete;
+
+    /** Most recent error. */
+    Error error() const;
+
+    /**
+     * @brief Open, parse and watch a repository.
+     * @param[in] dirName Repository directory.
+     * @param[in] configFile Configuration file. If empty, the repository directory is searched.
+     * @returns `true` if successful. Otherwise, `error()` will return an error description.
+     */
+    bool addRepository(const std::string &dirName, const std::string &configFile = "");
+
+    /** Directories of the watched repositories. */
+    std::vector<std::string> repositories() const;
+
+    /**
+     * @brief Accept queries on a Unix socket.
+     * @details An existing socket file at the path is replaced.
+     * @returns `true` if successful. Otherwise, `error()` will return an error description.
+     */
+    bool listen(const std::filesystem::path &socketPath);
+
+    /**
+     * @brief Answer one request.
+     * @param[in] request Request line, without the newline.
+     * @returns The reply, in the format sent over the socket.
+     */
+    std::string query(const std::string &request) const;
+
+    /**
+     * @brief Read pending ref changes and update the preview of every repository they touched.
+     * @details run() calls this after each batch of inotify events. A repository that fails to
+     * reload answers queries with `ERR` until it reloads successfully.
+     */
+    void refresh();
+
+    /**
+     * @brief Handle ref changes and queries until stop() is called.
+     * @returns `false` if waiting for events failed.
+     */
+    bool run();
+
+    /** Make run() return. Safe to call from another thread or a signal handler. */
+    void stop();
+
+private:
+    DaemonPrivate *d;
+};
+
+}
@@ -47,6 +47,15 @@ std::string Error::message() const
         case Error::GitNoRemotes:
             msg = "No git remotes found";
             break;
+        case Error::GitInvalidRepo:
+            msg = "Invalid git repository";
+            break;
+        case Error::GitPushFailed:
+            msg = "Unable to push to remote";
+            break;
+        case Error::GitWriteFailed:
+            msg = "Unable to write git objects";
+            break;
         case Error::VersionInvalid:
             msg = "Invalid version string";
             break;
@@ -59,6 +68,18 @@ std::string Error::message() const
         case Error::ConfigFileNotFound:
             msg = "Config file not found";
             break;
+        case Error::SocketFailed:
+            msg = "Unable to listen on socket";
+            break;
+        case Error::WatchFailed:
+            msg = "Unable to watch repository";
+            break;
+        case Error::PlanInvalid:
+            msg = "Invalid release plan";
+            break;
+        case Error::HeadMoved:
+            msg = "HEAD has moved since the release plan was made";
+            break;
         case Error::UnknownError:
         default:
             msg = "Unknown error";
@@ -34,6 +34,8 @@ public:
         ErrorCreatingTag,
         GitNoRemotes,
         GitInvalidRepo,
+        GitPushFailed,
+        GitWriteFailed,
 
         VersionInvalid,
 
@@ -46,6 +48,14 @@ public:
         ConfigFileNotFound,
         ConfigFileInvalid,
 
+        // Daemon
+        SocketFailed,
+        WatchFailed,
+
+        // Release plan
+        PlanInvalid,
+        HeadMoved,
+
         UnknownError = 255,
     };
 
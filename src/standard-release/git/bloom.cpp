@@ -0,0 +1,220 @@
+#include "bloom.h"
+#include "standard-release/git/cachefile.h"
+#include <algorithm>
+
+using namespace StandardRelease;
+
+static const uint32_t SEED_1 = 0x293ae76f;
+static const uint32_t SEED_2 = 0x7e646e2c;
+static const int HASH_COUNT = 7;
+static const int BITS_PER_PATH = 10;
+
+static const char INDEX_MAGIC[4] = { 'S', 'R', 'B', 'F' };
+static const uint32_t INDEX_VERSION = 1;
+static const size_t OID_SIZE = 20;
+
+static uint32_t rotl32(uint32_t x, int r)
+{
+    return (x << r) | (x >> (32 - r));
+}
+
+static uint32_t murmur3(uint32_t seed, const std::string &data)
+{
+    const uint32_t c1 = 0xcc9e2d51;
+    const uint32_t c2 = 0x1b873593;
+    const size_t len = data.length();
+    const auto *bytes = reinterpret_cast<const uint8_t *>(data.data());
+    const size_t blocks = len / 4;
+    uint32_t h = seed;
+
+    for (size_t i = 0; i < blocks; i++) {
+        uint32_t k = bytes[i * 4] | (bytes[i * 4 + 1] << 8) | (bytes[i * 4 + 2] << 16)
+                | (static_cast<uint32_t>(bytes[i * 4 + 3]) << 24);
+        k *= c1;
+        k = rotl32(k, 15);
+        k *= c2;
+        h ^= k;
+        h = rotl32(h, 13);
+        h = h * 5 + 0xe6546b64;
+    }
+
+    const uint8_t *tail = bytes + blocks * 4;
+    uint32_t k = 0;
+    switch (len & 3) {
+        case 3:
+            k ^= tail[2] << 16;
+            [[fallthrough]];
+        case 2:
+            k ^= tail[1] << 8;
+            [[fallthrough]];
+        case 1:
+            k ^= tail[0];
+            k *= c1;
+            k = rotl32(k, 15);
+            k *= c2;
+            h ^= k;
+    }
+
+    h ^= static_cast<uint32_t>(len);
+    h ^= h >> 16;
+    h *= 0x85ebca6b;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35;
+    h ^= h >> 16;
+
+    return h;
+}
+
+BloomFilter::BloomFilter()
+    : m_bits { 0xff }
+{
+}
+
+BloomFilter::BloomFilter(const std::vector<uint8_t> &bits)
+    : m_bits(bits)
+{
+    if (m_bits.empty()) {
+        m_bits = { 0xff };
+    }
+}
+
+BloomFilter BloomFilter::fromPaths(const std::vector<std::string> &paths)
+{
+    if (paths.size() > MaxChangedPaths) {
+        return BloomFilter();
+    }
+
+    // A commit with no changes still gets one (empty) byte, so it never matches.
+    const size_t bytes = std::max<size_t>(1, (paths.size() * BITS_PER_PATH + 7) / 8);
+    std::vector<uint8_t> bits(bytes, 0);
+    const uint64_t bitCount = bytes * 8;
+
+    for (const auto &path : paths) {
+        const uint32_t h1 = murmur3(SEED_1, path);
+        const uint32_t h2 = murmur3(SEED_2, path);
+        for (int i = 0; i < HASH_COUNT; i++) {
+            const uint64_t bit = (h1 + static_cast<uint64_t>(i) * h2) % bitCount;
+            bits[bit / 8] |= 1 << (bit % 8);
+        }
+    }
+
+    return BloomFilter(bits);
+}
+
+bool BloomFilter::contains(const std::string &path) const
+{
+    const uint64_t bitCount = m_bits.size() * 8;
+    const uint32_t h1 = murmur3(SEED_1, path);
+    const uint32_t h2 = murmur3(SEED_2, path);
+
+    for (int i = 0; i < HASH_COUNT; i++) {
+        const uint64_t bit = (h1 + static_cast<uint64_t>(i) * h2) % bitCount;
+        if ((m_bits[bit / 8] & (1 << (bit % 8))) == 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+const std::vector<uint8_t> &BloomFilter::bits() const
+{
+    return m_bits;
+}
+
+ChangedPathIndex::ChangedPathIndex()
+    : m_fileName()
+    , m_filters()
+    , m_dirty(false)
+{
+}
+
+bool ChangedPathIndex::load(const std::filesystem::path &fileName)
+{
+    uint32_t count = 0;
+
+    m_fileName = fileName;
+    m_filters.clear();
+    m_dirty = false;
+
+    CacheFileReader in(fileName);
+    if (!in.isOpen()) {
+        return true;
+    }
+
+    // Records: commit ID, filter length, filter bits.
+    if (!in.readHeader(INDEX_MAGIC, INDEX_VERSION, OID_SIZE + sizeof(uint32_t), count)) {
+        // Rebuilt from scratch on the next save().
+        m_dirty = true;
+        return false;
+    }
+
+    m_filters.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        std::string oid(OID_SIZE, '\0');
+        uint32_t length = 0;
+        std::vector<uint8_t> bits;
+
+        bool valid = in.read(oid.data(), OID_SIZE) && in.read(&length, sizeof(length))
+                && length <= in.remaining();
+        if (valid) {
+            bits.resize(length);
+            valid = in.read(bits.data(), length);
+        }
+        if (!valid) {
+            m_filters.clear();
+            m_dirty = true;
+            return false;
+        }
+
+        m_filters.emplace(std::move(oid), BloomFilter(bits));
+    }
+
+    in.finish();
+
+    return true;
+}
+
+bool ChangedPathIndex::save()
+{
+    if (!m_dirty || m_fileName.empty()) {
+        return true;
+    }
+
+    CacheFileWriter out(m_fileName);
+    if (!out.isOpen()) {
+        return false;
+    }
+
+    out.writeHeader(INDEX_MAGIC, INDEX_VERSION, m_filters.size());
+    for (const auto &[oid, filter] : m_filters) {
+        const uint32_t length = filter.bits().size();
+        out.write(oid.data(), OID_SIZE);
+        out.write(&length, sizeof(length));
+        out.write(filter.bits().data(), length);
+    }
+
+    if (!out.commit()) {
+        return false;
+    }
+
+    m_dirty = false;
+    return true;
+}
+
+const BloomFilter *ChangedPathIndex::find(const unsigned char *id) const
+{
+    const auto it = m_filters.find(std::string(reinterpret_cast<const char *>(id), OID_SIZE));
+    return it == m_filters.end() ? nullptr : &it->second;
+}
+
+void ChangedPathIndex::insert(const unsigned char *id, const BloomFilter &filter)
+{
+    m_filters[std::string(reinterpret_cast<const char *>(id), OID_SIZE)] = filter;
+    m_dirty = true;
+}
+
+size_t ChangedPathIndex::size() const
+{
+    return m_filters.size();
+}
@@ -0,0 +1,85 @@
+/**
+ * @file "standard-release/git/bloom.h"
+ * @brief Changed-path Bloom filters.
+ */
+#pragma once
+
+#include "standard-release/global/global.h"
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace StandardRelease {
+
+/**
+ * @brief Bloom filter of the paths changed by a single commit.
+ * @details Uses the same parameters as git's commit-graph bloom chunk: 10 bits per path,
+ * 7 hash functions derived from two seeded murmur3 hashes, and a "changed everything" filter
+ * for commits that touch more than 512 paths.
+ */
+class STANDARDRELEASE_EXPORT BloomFilter
+{
+public:
+    /** Commits changing more paths than this get a filter that matches every path. */
+    static const size_t MaxChangedPaths = 512;
+
+    /** Create a filter that matches every path. */
+    BloomFilter();
+
+    /** Create a filter from its serialized bits. */
+    BloomFilter(const std::vector<uint8_t> &bits);
+
+    /**
+     * @brief Create a filter from a list of changed paths.
+     * @details Every path should already be accompanied by its parent directories.
+     */
+    static BloomFilter fromPaths(const std::vector<std::string> &paths);
+
+    /** `false` if the path was definitely not changed; `true` if it may have been. */
+    bool contains(const std::string &path) const;
+
+    /** Serialized bits. */
+    const std::vector<uint8_t> &bits() const;
+
+private:
+    std::vector<uint8_t> m_bits;
+};
+
+/**
+ * @brief Persistent map of commit IDs to changed-path Bloom filters.
+ */
+class STANDARDRELEASE_EXPORT ChangedPathIndex
+{
+public:
+    ChangedPathIndex();
+
+    /**
+     * @brief Read an index file. A missing file is treated as an empty index.
+     * @returns `false` if the file exists but is not a valid index.
+     */
+    bool load(const std::filesystem::path &fileName);
+
+    /**
+     * @brief Write the index if any filters were added since load().
+     * @returns `true` if successful.
+     */
+    bool save();
+
+    /** Filter for a raw (20 byte) commit ID, or `nullptr` if not indexed. */
+    const BloomFilter *find(const unsigned char *id) const;
+
+    /** Add the filter for a raw (20 byte) commit ID. */
+    void insert(const unsigned char *id, const BloomFilter &filter);
+
+    /** Number of indexed commits. */
+    size_t size() const;
+
+private:
+    std::filesystem::path m_fileName;
+    std::unordered_map<std::string, BloomFilter> m_filters;
+    bool m_dirty;
+};
+
+}
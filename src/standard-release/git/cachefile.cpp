@@ -0,0 +1,138 @@
+#include "cachefile.h"
+#include "standard-release/stats/stats.h"
+#include <cstring>
+#include <fcntl.h>
+#include <system_error>
+#include <unistd.h>
+
+using namespace StandardRelease;
+
+CacheFileReader::CacheFileReader(const std::filesystem::path &fileName)
+    : m_in(fileName, std::ios::in | std::ios::binary)
+    , m_size(0)
+    , m_offset(0)
+{
+    std::error_code code;
+    const auto size = std::filesystem::file_size(fileName, code);
+    if (!code) {
+        m_size = size;
+    }
+}
+
+bool CacheFileReader::isOpen() const
+{
+    return m_in.is_open();
+}
+
+bool CacheFileReader::readHeader(const char (&magic)[4], uint32_t version, size_t recordSize,
+                                 uint32_t &count)
+{
+    char fileMagic[4];
+    uint32_t fileVersion = 0;
+
+    if (!read(fileMagic, sizeof(fileMagic)) || !read(&fileVersion, sizeof(fileVersion))
+        || !read(&count, sizeof(count))) {
+        return false;
+    }
+
+    return std::memcmp(fileMagic, magic, sizeof(fileMagic)) == 0 && fileVersion == version
+            && static_cast<uint64_t>(count) * recordSize <= remaining();
+}
+
+bool CacheFileReader::read(void *data, size_t size)
+{
+    if (size > remaining()) {
+        return false;
+    }
+
+    m_in.read(static_cast<char *>(data), size);
+    if (!m_in) {
+        return false;
+    }
+
+    m_offset += size;
+    return true;
+}
+
+uint64_t CacheFileReader::remaining() const
+{
+    return m_size - m_offset;
+}
+
+void CacheFileReader::finish()
+{
+    Stats::add(Stats::BytesRead, m_offset);
+}
+
+CacheFileWriter::CacheFileWriter(const std::filesystem::path &fileName)
+    : m_fileName(fileName)
+    , m_tmpName(fileName)
+    , m_out()
+    , m_committed(false)
+{
+    std::error_code code;
+
+    std::filesystem::create_directories(m_fileName.parent_path(), code);
+
+    // The temporary file doubles as the lock: only the writer that creates it may write the
+    // cache. Another writer that finds it skips its save, as the cache is only an optimization.
+    m_tmpName += ".lock";
+    const int fd = ::open(m_tmpName.c_str(), O_CREAT | O_EXCL | O_WRONLY, 0644);
+    if (fd == -1) {
+        m_tmpName.clear();
+        return;
+    }
+    ::close(fd);
+
+    m_out.open(m_tmpName, std::ios::out | std::ios::binary);
+}
+
+CacheFileWriter::~CacheFileWriter()
+{
+    std::error_code code;
+
+    if (!m_committed && !m_tmpName.empty()) {
+        m_out.close();
+        std::filesystem::remove(m_tmpName, code);
+    }
+}
+
+bool CacheFileWriter::isOpen() const
+{
+    return m_out.is_open();
+}
+
+void CacheFileWriter::writeHeader(const char (&magic)[4], uint32_t version, uint32_t count)
+{
+    write(magic, sizeof(magic));
+    write(&version, sizeof(version));
+    write(&count, sizeof(count));
+}
+
+void CacheFileWriter::write(const void *data, size_t size)
+{
+    m_out.write(static_cast<const char *>(data), size);
+}
+
+bool CacheFileWriter::commit()
+{
+    std::error_code code;
+
+    m_out.close();
+    if (!m_out) {
+        return false;
+    }
+
+    const auto bytes = std::filesystem::file_size(m_tmpName, code);
+    if (!code) {
+        Stats::add(Stats::BytesWritten, bytes);
+    }
+
+    std::filesystem::rename(m_tmpName, m_fileName, code);
+    if (code) {
+        return false;
+    }
+
+    m_committed = true;
+    return true;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file "standard-release/git/cachefile.h"
+ * @brief Binary cache files kept under `.git/standard-release`.
+ */
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+
+namespace StandardRelease {
+
+/**
+ * @brief Reads a cache file: a 4-byte magic, a version, a record count, then the records.
+ * @details Every read is checked against the size of the file, so a corrupt or truncated cache
+ * is rejected before anything is allocated for it.
+ */
+class CacheFileReader
+{
+public:
+    explicit CacheFileReader(const std::filesystem::path &fileName);
+
+    /** `false` if the file does not exist or cannot be read. */
+    bool isOpen() const;
+
+    /**
+     * @brief Read and check the header.
+     * @param recordSize Smallest possible size of one record. A count that cannot fit in the
+     * rest of the file is rejected.
+     * @returns `false` if the file is not a cache with this magic and version.
+     */
+    bool readHeader(const char (&magic)[4], uint32_t version, size_t recordSize,
+                    uint32_t &count);
+
+    /** Read `size` bytes; `false` if the file ends first. */
+    bool read(void *data, size_t size);
+
+    /** Number of bytes not read yet. */
+    uint64_t remaining() const;
+
+    /** Add the bytes read to the run statistics. */
+    void finish();
+
+private:
+    std::ifstream m_in;
+    uint64_t m_size;
+    uint64_t m_offset;
+};
+
+/**
+ * @brief Writes a cache file.
+ * @details Everything goes to a temporary file first, so a concurrent reader never sees half a
+ * cache. commit() moves it into place; otherwise it is removed. The temporary file is created
+ * exclusively and serves as a lock, so of two concurrent writers only the first one can write.
+ */
+class CacheFileWriter
+{
+public:
+    explicit CacheFileWriter(const std::filesystem::path &fileName);
+    ~CacheFileWriter();
+
+    CacheFileWriter(const CacheFileWriter &) = delete;
+    CacheFileWriter &operator=(const CacheFileWriter &) = delete;
+
+    /** `false` if the temporary file could not be created or another writer holds it. */
+    bool isOpen() const;
+
+    void writeHeader(const char (&magic)[4], uint32_t version, uint32_t count);
+
+    void write(const void *data, size_t size);
+
+    /**
+     * @brief Replace the cache file with what was written.
+     * @returns `true` if successful.
+     */
+    bool commit();
+
+private:
+    std::filesystem::path m_fileName;
+    std::filesystem::path m_tmpName;
+    std::ofstream m_out;
+    bool m_committed;
+};
+
+}
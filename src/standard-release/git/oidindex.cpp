@@ -0,0 +1,118 @@
+#include "oidindex.h"
+#include "git2/odb.h"
+#include "git2/oid.h"
+#include "git2/repository.h"
+#include <algorithm>
+
+using namespace StandardRelease;
+
+static const int DEFAULT_ABBREV = 7;
+static const int MAX_ABBREV = 40;
+
+static uint64_t prefixOf(const unsigned char *id)
+{
+    uint64_t prefix = 0;
+    for (int i = 0; i < 8; i++) {
+        prefix = (prefix << 8) | id[i];
+    }
+    return prefix;
+}
+
+// Number of leading hex digits shared by two prefixes.
+static int commonDigits(uint64_t a, uint64_t b)
+{
+    const uint64_t diff = a ^ b;
+    if (diff == 0) {
+        return 16;
+    }
+    return __builtin_clzll(diff) / 4;
+}
+
+OidIndex::OidIndex()
+    : m_prefixes()
+{
+}
+
+bool OidIndex::build(git_repository *repo)
+{
+    git_odb *odb = nullptr;
+
+    clear();
+
+    int ret = git_repository_odb(&odb, repo);
+    if (ret != GIT_OK) {
+        return false;
+    }
+
+    auto cb = [](const git_oid *oid, void *payload) {
+        static_cast<OidIndex *>(payload)->insert(oid->id);
+        return 0;
+    };
+
+    ret = git_odb_foreach(odb, cb, this);
+    git_odb_free(odb);
+
+    sort();
+
+    return ret == GIT_OK;
+}
+
+void OidIndex::insert(const unsigned char *id)
+{
+    m_prefixes.push_back(prefixOf(id));
+}
+
+void OidIndex::sort()
+{
+    // Loose and packed copies of the same object are reported separately.
+    std::sort(m_prefixes.begin(), m_prefixes.end());
+    m_prefixes.erase(std::unique(m_prefixes.begin(), m_prefixes.end()), m_prefixes.end());
+}
+
+void OidIndex::clear()
+{
+    m_prefixes.clear();
+}
+
+size_t OidIndex::size() const
+{
+    return m_prefixes.size();
+}
+
+bool OidIndex::empty() const
+{
+    return m_prefixes.empty();
+}
+
+int OidIndex::minimumLength() const
+{
+    const uint64_t count = m_prefixes.size();
+    if (count == 0) {
+        return DEFAULT_ABBREV;
+    }
+
+    // Same estimate as git: half the bits needed to count the objects, rounded up.
+    const int bits = 64 - __builtin_clzll(count);
+    return std::max(DEFAULT_ABBREV, (bits + 1) / 2);
+}
+
+int OidIndex::abbrevLength(const unsigned char *id) const
+{
+    const uint64_t prefix = prefixOf(id);
+    int needed = 0;
+
+    auto it = std::lower_bound(m_prefixes.begin(), m_prefixes.end(), prefix);
+
+    // Only the sorted neighbours can share a longer prefix than any other object.
+    if (it != m_prefixes.begin()) {
+        needed = std::max(needed, commonDigits(prefix, *(it - 1)) + 1);
+    }
+    if (it != m_prefixes.end() && *it == prefix) {
+        it++;
+    }
+    if (it != m_prefixes.end()) {
+        needed = std::max(needed, commonDigits(prefix, *it) + 1);
+    }
+
+    return std::min(MAX_ABBREV, std::max(needed, minimumLength()));
+}
@@ -0,0 +1,66 @@
+/**
+ * @file "standard-release/git/oidindex.h"
+ * @brief Unique object ID abbreviations.
+ */
+#pragma once
+
+#include "standard-release/global/global.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct git_repository;
+
+namespace StandardRelease {
+
+/**
+ * @brief Sorted array of object ID prefixes.
+ * @details Built once per run from every object in the repository, so the shortest unique
+ * abbreviation of any object can be found with a binary search instead of an object lookup.
+ * Only the first 64 bits of each ID are kept, which makes abbreviations exact up to 16 hex
+ * digits.
+ */
+class STANDARDRELEASE_EXPORT OidIndex
+{
+public:
+    OidIndex();
+
+    /**
+     * @brief Index every object in a repository.
+     * @returns `true` if successful.
+     */
+    bool build(git_repository *repo);
+
+    /** Add a raw (20 byte) object ID. Call sort() once all IDs have been added. */
+    void insert(const unsigned char *id);
+
+    /** Sort and de-duplicate the index. */
+    void sort();
+
+    /** Remove all IDs. */
+    void clear();
+
+    /** Number of indexed objects. */
+    size_t size() const;
+
+    /** Has the index been built? */
+    bool empty() const;
+
+    /**
+     * @brief Minimum abbreviation length.
+     * @details Grows with the number of objects, like git's `core.abbrev=auto` (never below 7).
+     */
+    int minimumLength() const;
+
+    /**
+     * @brief Shortest unique abbreviation for an object.
+     * @param[in] id Raw (20 byte) object ID.
+     * @returns Number of hex digits needed so that no other indexed object shares the prefix.
+     */
+    int abbrevLength(const unsigned char *id) const;
+
+private:
+    std::vector<uint64_t> m_prefixes;
+};
+
+}
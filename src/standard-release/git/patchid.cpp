@@ -0,0 +1,96 @@
+#include "patchid.h"
+#include "standard-release/git/cachefile.h"
+
+using namespace StandardRelease;
+
+static const char CACHE_MAGIC[4] = { 'S', 'R', 'P', 'I' };
+static const uint32_t CACHE_VERSION = 1;
+static const size_t OID_SIZE = 20;
+
+PatchIdCache::PatchIdCache()
+    : m_fileName()
+    , m_patchIds()
+    , m_dirty(false)
+{
+}
+
+bool PatchIdCache::load(const std::filesystem::path &fileName)
+{
+    uint32_t count = 0;
+
+    m_fileName = fileName;
+    m_patchIds.clear();
+    m_dirty = false;
+
+    CacheFileReader in(fileName);
+    if (!in.isOpen()) {
+        return true;
+    }
+
+    // Fixed-size records: commit ID, then patch ID.
+    std::string records;
+    bool valid = in.readHeader(CACHE_MAGIC, CACHE_VERSION, OID_SIZE * 2, count);
+    if (valid) {
+        records.resize(count * OID_SIZE * 2);
+        valid = in.read(records.data(), records.size());
+    }
+    if (!valid) {
+        // Rebuilt from scratch on the next save().
+        m_dirty = true;
+        return false;
+    }
+
+    m_patchIds.reserve(count);
+    for (size_t offset = 0; offset < records.size(); offset += OID_SIZE * 2) {
+        m_patchIds.emplace(records.substr(offset, OID_SIZE),
+                           records.substr(offset + OID_SIZE, OID_SIZE));
+    }
+
+    in.finish();
+
+    return true;
+}
+
+bool PatchIdCache::save()
+{
+    if (!m_dirty || m_fileName.empty()) {
+        return true;
+    }
+
+    CacheFileWriter out(m_fileName);
+    if (!out.isOpen()) {
+        return false;
+    }
+
+    out.writeHeader(CACHE_MAGIC, CACHE_VERSION, m_patchIds.size());
+    for (const auto &[id, patchId] : m_patchIds) {
+        out.write(id.data(), OID_SIZE);
+        out.write(patchId.data(), OID_SIZE);
+    }
+
+    if (!out.commit()) {
+        return false;
+    }
+
+    m_dirty = false;
+    return true;
+}
+
+const unsigned char *PatchIdCache::find(const unsigned char *id) const
+{
+    const auto it = m_patchIds.find(std::string(reinterpret_cast<const char *>(id), OID_SIZE));
+    return it == m_patchIds.end() ? nullptr
+                                  : reinterpret_cast<const unsigned char *>(it->second.data());
+}
+
+void PatchIdCache::insert(const unsigned char *id, const unsigned char *patchId)
+{
+    m_patchIds[std::string(reinterpret_cast<const char *>(id), OID_SIZE)]
+            = std::string(reinterpret_cast<const char *>(patchId), OID_SIZE);
+    m_dirty = true;
+}
+
+size_t PatchIdCache::size() const
+{
+    return m_patchIds.size();
+}
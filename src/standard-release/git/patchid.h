@@ -0,0 +1,53 @@
+/**
+ * @file "standard-release/git/patchid.h"
+ * @brief Cache of commit patch IDs.
+ */
+#pragma once
+
+#include "standard-release/global/global.h"
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+
+namespace StandardRelease {
+
+/**
+ * @brief Persistent map of commit IDs to patch IDs.
+ * @details A patch ID identifies the change a commit makes independently of its parents,
+ * author and message (like `git patch-id --stable`), so a cherry-pick has the same patch ID as
+ * the original commit. Computing one needs a diff; the cache makes that a one-time cost per
+ * commit.
+ */
+class STANDARDRELEASE_EXPORT PatchIdCache
+{
+public:
+    PatchIdCache();
+
+    /**
+     * @brief Read a cache file. A missing file is treated as an empty cache.
+     * @returns `false` if the file exists but is not a valid cache.
+     */
+    bool load(const std::filesystem::path &fileName);
+
+    /**
+     * @brief Write the cache if any patch IDs were added since load().
+     * @returns `true` if successful.
+     */
+    bool save();
+
+    /** Raw (20 byte) patch ID of a raw commit ID, or `nullptr` if not cached. */
+    const unsigned char *find(const unsigned char *id) const;
+
+    /** Add the raw (20 byte) patch ID of a raw commit ID. */
+    void insert(const unsigned char *id, const unsigned char *patchId);
+
+    /** Number of cached commits. */
+    size_t size() const;
+
+private:
+    std::filesystem::path m_fileName;
+    std::unordered_map<std::string, std::string> m_patchIds;
+    bool m_dirty;
+};
+
+}
@@ -1,10 +1,15 @@
 #include "repository.h"
 #include "git2/branch.h"
 #include "git2/commit.h"
+#include "git2/diff.h"
 #include "git2/errors.h"
 #include "git2/global.h"
 #include "git2/graph.h"
 #include "git2/index.h"
+#include "git2/oid.h"
+#include "git2/odb.h"
+#include "git2/odb_backend.h"
+#include "git2/pack.h"
 #include "git2/refs.h"
 #include "git2/remote.h"
 #include "git2/repository.h"
@@ -12,10 +17,23 @@
 #include "git2/revwalk.h"
 #include "git2/signature.h"
 #include "git2/status.h"
+#include "git2/sys/mempack.h"
 #include "git2/tag.h"
+#include "git2/transaction.h"
+#include "git2/tree.h"
 #include "standard-release/errors/error.h"
+#include "standard-release/log/ilog.h"
+#include "standard-release/stats/stats.h"
+#include "standard-release/tasks/scheduler.h"
+#include "standard-release/trace/trace.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstring>
 #include <filesystem>
 #include <iostream>
+#include <memory>
 #include <regex>
 #include <system_error>
 
@@ -31,19 +49,132 @@ static const char *git2error()
     return "";
 }
 
+static bool isSpace(char c)
+{
+    return std::isspace(static_cast<unsigned char>(c)) != 0;
+}
+
+GitRepository::Commit::Commit(const char *summary, const char *body, const char *hash,
+                              const char *id)
+    : hash(hash)
+    , id(id)
+    , m_message(summary)
+{
+    if (*body != '\0') {
+        m_message.append("\n\n").append(body);
+    }
+    index();
+}
+
+GitRepository::Commit GitRepository::Commit::fromMessage(std::string message, const char *hash,
+                                                         const char *id)
+{
+    Commit commit("", "", hash, id);
+    commit.m_message = std::move(message);
+    commit.index();
+    return commit;
+}
+
+std::string_view GitRepository::Commit::body() const
+{
+    std::string_view body = std::string_view(m_message).substr(m_bodyOffset);
+    while (!body.empty() && isSpace(body.back())) {
+        body.remove_suffix(1);
+    }
+    return body;
+}
+
+// Locate the summary and body as git_commit_summary() and git_commit_body() do. A summary that
+// spans several lines is joined in place, so it can still be a view.
+void GitRepository::Commit::index()
+{
+    size_t begin = m_message.find_first_not_of('\n');
+    if (begin == std::string::npos) {
+        m_summaryOffset = m_summaryLength = 0;
+        m_bodyOffset = static_cast<uint32_t>(m_message.size());
+        return;
+    }
+
+    size_t end = m_message.find("\n\n", begin);
+    if (end == std::string::npos) {
+        end = m_message.size();
+    }
+    const size_t bodyBegin = end;
+    while (end > begin && isSpace(m_message[end - 1])) {
+        end--;
+    }
+
+    const size_t newline = m_message.find('\n', begin);
+    if (newline < end) {
+        std::string summary;
+        summary.reserve(end - begin);
+        for (size_t i = begin; i < end;) {
+            if (!isSpace(m_message[i])) {
+                summary += m_message[i++];
+                continue;
+            }
+            const size_t run = i;
+            while (isSpace(m_message[i])) {
+                i++;
+            }
+            if (std::memchr(m_message.data() + run, '\n', i - run) != nullptr) {
+                summary += ' ';
+            } else {
+                summary.append(m_message, run, i - run);
+            }
+        }
+        end = summary.size();
+        m_message = std::move(summary) + m_message.substr(bodyBegin);
+        begin = 0;
+        m_bodyOffset = static_cast<uint32_t>(end);
+    } else {
+        m_bodyOffset = static_cast<uint32_t>(bodyBegin);
+    }
+
+    while (m_bodyOffset < m_message.size() && isSpace(m_message[m_bodyOffset])) {
+        m_bodyOffset++;
+    }
+    m_summaryOffset = static_cast<uint32_t>(begin);
+    m_summaryLength = static_cast<uint32_t>(end - begin);
+}
+
+/**
+ * @brief Writes buffered between beginBatch() and commitBatch().
+ */
+struct StandardRelease::GitBatch
+{
+    /** In-memory object database backend; owned by the repository's ODB. */
+    git_odb_backend *mempack = nullptr;
+    /** Queued ref updates, applied in order. */
+    std::vector<std::pair<std::string, git_oid>> refs;
+    /** Release commit created in this batch (not yet visible through `HEAD`). */
+    git_oid head;
+    bool hasHead = false;
+    /** Parent of the first commit in the batch; everything it reaches is already stored. */
+    git_oid base;
+    bool hasBase = false;
+};
+
 GitRepository::GitRepository()
     : m_error()
     , m_repo()
     , m_open(false)
     , m_commits()
+    , m_headId()
     , m_remoteUrl()
     , m_url()
+    , m_walkMode(Default)
+    , m_usePathIndex(false)
+    , m_detectDuplicates(false)
+    , m_patchIds()
+    , m_batch(nullptr)
 {
     git_libgit2_init();
 }
 
 GitRepository::~GitRepository()
 {
+    delete m_batch;
     if (m_repo != nullptr) {
         git_repository_free(m_repo);
     }
@@ -64,11 +195,93 @@ Error GitRepository::error() const
     return m_error;
 }
 
+bool GitRepository::walkModeFromName(const std::string &name, WalkMode &mode)
+{
+    if (name.empty() || name == "default") {
+        mode = Default;
+    } else if (name == "first-parent") {
+        mode = FirstParent;
+    } else if (name == "topological") {
+        mode = Topological;
+    } else if (name == "time") {
+        mode = Time;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+GitRepository::WalkMode GitRepository::walkMode() const
+{
+    return m_walkMode;
+}
+
+void GitRepository::setWalkMode(WalkMode mode)
+{
+    m_walkMode = mode;
+}
+
+bool GitRepository::pathIndex() const
+{
+    return m_usePathIndex;
+}
+
+void GitRepository::setPathIndex(bool enabled)
+{
+    m_usePathIndex = enabled;
+}
+
+bool GitRepository::detectDuplicates() const
+{
+    return m_detectDuplicates;
+}
+
+void GitRepository::setDetectDuplicates(bool enabled)
+{
+    m_detectDuplicates = enabled;
+}
+
+std::string GitRepository::pathFilter() const
+{
+    return m_pathFilter;
+}
+
+void GitRepository::setPathFilter(const std::string &path)
+{
+    std::string filter = path;
+
+    while (filter.compare(0, 2, "./") == 0) {
+        filter.erase(0, 2);
+    }
+    while (!filter.empty() && filter.back() == '/') {
+        filter.pop_back();
+    }
+
+    m_pathFilter = filter == "." ? "" : filter;
+}
+
 std::list<GitRepository::Commit> GitRepository::commits() const
 {
     return m_commits;
 }
 
+std::string GitRepository::headId() const
+{
+    return m_headId;
+}
+
+std::string GitRepository::currentHeadId() const
+{
+    git_oid head;
+    char id[GIT_OID_HEXSZ + 1];
+
+    if (!m_open || git_reference_name_to_id(&head, m_repo, "HEAD") != GIT_OK) {
+        return "";
+    }
+
+    return git_oid_tostr(id, sizeof(id), &head);
+}
+
 std::filesystem::path GitRepository::dirName() const
 {
     return m_dirname;
@@ -123,95 +336,355 @@ int GitRepository::countUnpushed()
     return ahead;
 }
 
+struct PushPayload
+{
+    std::chrono::steady_clock::time_point start;
+    GitRepository::PushStats *stats;
+};
+
+static double elapsedMs(const std::chrono::steady_clock::time_point &start)
+{
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::milli>(elapsed).count();
+}
+
+// Called once the remote has agreed on the ref updates (before the packfile is sent).
+static int pushNegotiation(const git_push_update **, size_t, void *payload)
+{
+    auto data = static_cast<PushPayload *>(payload);
+    data->stats->negotiationMs = elapsedMs(data->start);
+    return 0;
+}
+
+static int pushTransferProgress(unsigned int, unsigned int total, size_t bytes, void *payload)
+{
+    auto data = static_cast<PushPayload *>(payload);
+    data->stats->objects = total;
+    data->stats->bytes = bytes;
+    return 0;
+}
+
+std::string GitRepository::headName()
+{
+    git_reference *head = nullptr;
+
+    const int ret = git_repository_head(&head, m_repo);
+    if (ret != GIT_OK) {
+        m_error = Error(Error::GitInvalidRepo, git2error());
+        return "";
+    }
+
+    const std::string name = git_reference_name(head);
+    git_reference_free(head);
+
+    return name;
+}
+
+GitRepository::PushStats GitRepository::pushStats() const
+{
+    return m_pushStats;
+}
+
 bool GitRepository::push(const std::string &name)
 {
+    return push(std::vector<std::string> { name });
+}
+
+bool GitRepository::push(const std::vector<std::string> &names)
+{
+    TraceSpan span("push", "git");
+
     int ret;
-    git_reference *head = nullptr;
     git_push_options options;
     git_remote *remote = nullptr;
+    std::vector<std::string> refspecs;
+    std::vector<const char *> refspecPtrs;
     const char *remoteName = "origin"; // TODO: Do not hardcode origin.
+    PushPayload payload { std::chrono::steady_clock::now(), &m_pushStats };
 
-    // ret = git_repository_head(&head, m_repo);
-    ret = git_reference_lookup(&head, m_repo, name.c_str());
-    if (ret != GIT_OK) {
-        m_error = Error(Error::GitInvalidRepo, git2error());
-        return false;
-    }
+    m_pushStats = PushStats();
+
+    for (const auto &name : names) {
+        git_reference *ref = nullptr;
 
-    const char *refspec = git_reference_name(head);
-    const git_strarray refspecs = { (char **)&refspec, 1 };
+        ret = git_reference_lookup(&ref, m_repo, name.c_str());
+        if (ret != GIT_OK) {
+            m_error = Error(Error::GitInvalidRepo, git2error());
+            return false;
+        }
 
-    const int ahead = countUnpushed();
-    if (ahead != 1) {
-        // throw Exception('')
+        const std::string refName = git_reference_name(ref);
+        refspecs.push_back(refName + ":" + refName);
+        git_reference_free(ref);
     }
 
-    git_reference_free(head);
+    for (const auto &refspec : refspecs) {
+        refspecPtrs.push_back(refspec.c_str());
+    }
+    const git_strarray strarray = { const_cast<char **>(refspecPtrs.data()), refspecPtrs.size() };
 
-    // std::cout << "Ahead by " << countUnpushed() << std::endl;
-    // std::cout << "refspec = " << refspec << "\n";
+    m_pushStats.refs = refspecs.size();
+    // A branch without an upstream yet counts as 0 ahead; that is not an error of the push.
+    const Error error = m_error;
+    m_pushStats.ahead = countUnpushed();
+    m_error = error;
 
     ret = git_remote_lookup(&remote, m_repo, remoteName);
     if (ret != GIT_OK) {
-        throw Exception(git2error());
-        m_error = Error(Error::InternalError, git2error());
+        m_error = Error(Error::GitPushFailed, git2error());
         return false;
     }
 
     ret = git_push_options_init(&options, GIT_PUSH_OPTIONS_VERSION);
     if (ret != GIT_OK) {
-        throw Exception(git2error());
         m_error = Error(Error::InternalError, git2error());
+        git_remote_free(remote);
         return false;
     }
 
-    ret = git_remote_push(remote, &refspecs, &options);
+    options.callbacks.push_negotiation = pushNegotiation;
+    options.callbacks.push_transfer_progress = pushTransferProgress;
+    options.callbacks.payload = &payload;
+
+    ret = git_remote_push(remote, &strarray, &options);
+    git_remote_free(remote);
     if (ret != GIT_OK) {
-        throw Exception(git2error());
-        m_error = Error(Error::InternalError, git2error());
+        m_error = Error(Error::GitPushFailed, git2error());
         return false;
     }
 
+    m_pushStats.totalMs = elapsedMs(payload.start);
+
     return true;
 }
 
 bool GitRepository::createRelease(const std::string &version)
+{
+    const auto commitMsg = std::string("chore(release): ") + version;
+    const auto versionStr = "v" + version;
+
+    return createRelease(commitMsg, { versionStr });
+}
+
+bool GitRepository::createRelease(const std::string &message, const std::vector<std::string> &tags)
 {
     bool r;
-    auto commitMsg = std::string("chore(release): ") + version;
-    auto versionStr = "v" + version;
 
-    r = commit(commitMsg);
+    r = beginBatch();
+    if (!r) {
+        throw Exception("Error preparing release");
+    }
+
+    // Both report through m_error; the batch is dropped so the repository stays usable.
+    r = commit(message);
     if (!r) {
-        throw Exception("Error commiting changes");
+        const Error error = m_error;
+        abortBatch();
+        throw Exception("Error commiting changes: " + error.message());
     }
 
-    r = createTag(versionStr, commitMsg);
+    for (const auto &tag : tags) {
+        r = createTag(tag, message);
+        if (!r) {
+            const Error error = m_error;
+            abortBatch();
+            throw Exception(error);
+        }
+    }
+
+    r = commitBatch();
     if (!r) {
-        throw Exception("Error creating tag");
+        throw Exception("Error writing release");
     }
 
     if (!remoteUrl().empty()) {
-        const std::string headRef = "refs/heads/master"; // "HEAD";
-        const std::string tagRef = "refs/tags/" + versionStr;
+        std::vector<std::string> refs { headName() };
+        for (const auto &tag : tags) {
+            refs.push_back("refs/tags/" + tag);
+        }
 
-        r = push(headRef);
+        // Branch and tags go out together so the remote never sees one without the other.
+        r = push(refs);
         if (!r) {
             throw Exception("Error pushing to origin");
         }
+    }
 
-        r = push(tagRef);
-        if (!r) {
-            throw Exception("Error pushing tag");
+    // Not working yet.
+    return true;
+}
+
+bool GitRepository::beginBatch()
+{
+    int ret;
+    git_odb *odb = nullptr;
+    git_odb_backend *mempack = nullptr;
+
+    if (!m_open) {
+        m_error = Error(Error::InternalError, "beginBatch() called before repo was opened");
+        return false;
+    }
+
+    if (m_batch != nullptr) {
+        m_error = Error(Error::InternalError, "beginBatch() called twice");
+        return false;
+    }
+
+    ret = git_repository_odb(&odb, m_repo);
+    if (ret != GIT_OK) {
+        m_error = Error(Error::GitWriteFailed, git2error());
+        return false;
+    }
+
+    ret = git_mempack_new(&mempack);
+    if (ret != GIT_OK) {
+        m_error = Error(Error::GitWriteFailed, git2error());
+        git_odb_free(odb);
+        return false;
+    }
+
+    // Highest priority, so every new object lands in memory instead of a loose file.
+    ret = git_odb_add_backend(odb, mempack, 999);
+    git_odb_free(odb);
+    if (ret != GIT_OK) {
+        m_error = Error(Error::GitWriteFailed, git2error());
+        return false;
+    }
+
+    m_batch = new GitBatch();
+    m_batch->mempack = mempack;
+
+    return true;
+}
+
+bool GitRepository::commitBatch()
+{
+    TraceSpan span("write-pack", "git");
+
+    int ret;
+    git_buf pack = GIT_BUF_INIT;
+    git_packbuilder *packbuilder = nullptr;
+    git_revwalk *walker = nullptr;
+    git_odb *odb = nullptr;
+    git_odb_writepack *writepack = nullptr;
+    git_indexer_progress progress = {};
+    git_transaction *transaction = nullptr;
+
+    if (m_batch == nullptr) {
+        m_error = Error(Error::InternalError, "commitBatch() called without beginBatch()");
+        return false;
+    }
+
+    // Pack only what the batch created: the new commits with the trees and blobs their parent
+    // does not already have, plus the queued tag objects. (git_mempack_dump() would pack each
+    // commit's whole tree and drop the tags.)
+    ret = git_packbuilder_new(&packbuilder, m_repo);
+    if (ret == GIT_OK && m_batch->hasHead) {
+        ret = git_revwalk_new(&walker, m_repo);
+        if (ret == GIT_OK) {
+            ret = git_revwalk_push(walker, &m_batch->head);
+        }
+        if (ret == GIT_OK && m_batch->hasBase) {
+            ret = git_revwalk_hide(walker, &m_batch->base);
         }
+        if (ret == GIT_OK) {
+            ret = git_packbuilder_insert_walk(packbuilder, walker);
+        }
+        git_revwalk_free(walker);
+    }
+    for (const auto &[name, oid] : m_batch->refs) {
+        if (ret == GIT_OK) {
+            ret = git_packbuilder_insert(packbuilder, &oid, name.c_str());
+        }
+    }
+    if (ret == GIT_OK) {
+        ret = git_packbuilder_write_buf(&pack, packbuilder);
+    }
+    git_packbuilder_free(packbuilder);
+    if (ret != GIT_OK) {
+        m_error = Error(Error::GitWriteFailed, git2error());
+        abortBatch();
+        return false;
     }
 
-    // Not working yet.
+    // Every object from the batch is written as one packfile.
+    ret = git_repository_odb(&odb, m_repo);
+    if (ret == GIT_OK) {
+        ret = git_odb_write_pack(&writepack, odb, nullptr, nullptr);
+    }
+    if (ret == GIT_OK) {
+        ret = writepack->append(writepack, pack.ptr, pack.size, &progress);
+    }
+    if (ret == GIT_OK) {
+        ret = writepack->commit(writepack, &progress);
+    }
+    if (ret == GIT_OK) {
+        Stats::add(Stats::BytesWritten, pack.size);
+    }
+    if (writepack != nullptr) {
+        writepack->free(writepack);
+    }
+    git_odb_free(odb);
+    git_buf_dispose(&pack);
+
+    if (ret != GIT_OK) {
+        m_error = Error(Error::GitWriteFailed, git2error());
+        abortBatch();
+        return false;
+    }
+
+    // Every ref update is applied in one transaction.
+    ret = git_transaction_new(&transaction, m_repo);
+    for (const auto &[name, oid] : m_batch->refs) {
+        if (ret == GIT_OK) {
+            ret = git_transaction_lock_ref(transaction, name.c_str());
+        }
+        if (ret == GIT_OK) {
+            ret = git_transaction_set_target(transaction, name.c_str(), &oid, nullptr,
+                                             "standard-release");
+        }
+    }
+    if (ret == GIT_OK) {
+        ret = git_transaction_commit(transaction);
+    }
+    git_transaction_free(transaction);
+
+    if (ret != GIT_OK) {
+        m_error = Error(Error::GitWriteFailed, git2error());
+        abortBatch();
+        return false;
+    }
+
+    abortBatch();
+
     return true;
 }
 
+// Drop the batch state. The ODB cannot remove a backend, so the repository is reopened to
+// detach the in-memory one; anything not yet flushed is discarded.
+void GitRepository::abortBatch()
+{
+    if (m_batch == nullptr) {
+        return;
+    }
+
+    delete m_batch;
+    m_batch = nullptr;
+
+    git_repository_free(m_repo);
+    m_repo = nullptr;
+
+    const int ret = git_repository_open(&m_repo, m_dirname.string().c_str());
+    if (ret != GIT_OK) {
+        m_error = Error(Error::ErrorOpeningGitRepo, git2error());
+        m_open = false;
+    }
+}
+
 bool GitRepository::open(const std::filesystem::path &repo)
 {
+    TraceSpan span("open", "git");
+
     std::error_code code;
     int ret;
     bool result;
@@ -241,6 +714,8 @@ bool GitRepository::open(const std::filesystem::path &repo)
 
 bool GitRepository::createTag(const std::string &name, const std::string msg)
 {
+    TraceSpan span("tag", "git");
+
     int ret;
     std::stringstream estr;
     git_signature *sig = nullptr;
@@ -248,8 +723,13 @@ bool GitRepository::createTag(const std::string &name, const std::string msg)
     git_object *obj = nullptr;
     const char *target = "HEAD";
     const int force = 0;
+    const std::string refName = "refs/tags/" + name;
 
-    ret = git_revparse_single(&obj, m_repo, target);
+    if (m_batch != nullptr && m_batch->hasHead) {
+        ret = git_object_lookup(&obj, m_repo, &m_batch->head, GIT_OBJECT_COMMIT);
+    } else {
+        ret = git_revparse_single(&obj, m_repo, target);
+    }
     if (ret != GIT_OK) {
         m_error = Error(Error::GitInvalidSpec, git2error());
         return false;
@@ -258,20 +738,215 @@ bool GitRepository::createTag(const std::string &name, const std::string msg)
     ret = git_signature_default(&sig, m_repo);
     if (ret != GIT_OK) {
         m_error = Error(Error::GitBadSignature, git2error());
+        git_object_free(obj);
         return false;
     }
 
-    ret = git_tag_create(&oid, m_repo, name.c_str(), obj, sig, msg.c_str(), force);
-    if (ret != GIT_OK) {
-        m_error = Error(Error::ErrorCreatingTag, git2error());
-        return false;
+    if (m_batch != nullptr) {
+        git_oid existing;
+
+        // Only the tag object is written now; the ref waits for commitBatch().
+        ret = git_reference_name_to_id(&existing, m_repo, refName.c_str());
+        if (ret == GIT_OK) {
+            m_error = Error(Error::ErrorCreatingTag, name + " already exists");
+            ret = GIT_ERROR;
+        } else {
+            ret = git_tag_annotation_create(&oid, m_repo, name.c_str(), obj, sig, msg.c_str());
+            if (ret == GIT_OK) {
+                m_batch->refs.push_back({ refName, oid });
+            } else {
+                m_error = Error(Error::ErrorCreatingTag, git2error());
+            }
+        }
+    } else {
+        ret = git_tag_create(&oid, m_repo, name.c_str(), obj, sig, msg.c_str(), force);
+        if (ret != GIT_OK) {
+            m_error = Error(Error::ErrorCreatingTag, git2error());
+        }
     }
 
     git_object_free(obj);
     git_signature_free(sig);
 
-    // Not done?
-    // return false;
+    return ret == GIT_OK;
+}
+
+// Compare the entry at `path` in two trees, one path component at a time. Stops as soon as
+// both sides share an object ID, so unchanged subtrees are never loaded.
+static bool pathChanged(git_repository *repo, const git_oid *oldTree, const git_oid *newTree,
+                        const std::string &path)
+{
+    git_oid oldId;
+    git_oid newId;
+    bool hasOld = oldTree != nullptr;
+    bool hasNew = newTree != nullptr;
+    size_t begin = 0;
+
+    if (hasOld) {
+        oldId = *oldTree;
+    }
+    if (hasNew) {
+        newId = *newTree;
+    }
+
+    while (true) {
+        if (!hasOld && !hasNew) {
+            return false;
+        }
+        if (hasOld && hasNew && git_oid_equal(&oldId, &newId)) {
+            return false;
+        }
+        if (begin > path.length()) {
+            // Added, removed, or present on both sides with different contents.
+            return true;
+        }
+
+        size_t end = path.find('/', begin);
+        if (end == std::string::npos) {
+            end = path.length();
+        }
+        const std::string name = path.substr(begin, end - begin);
+        begin = end + 1;
+
+        for (int side = 0; side < 2; side++) {
+            git_oid *id = side == 0 ? &oldId : &newId;
+            bool *has = side == 0 ? &hasOld : &hasNew;
+            git_tree *tree = nullptr;
+
+            if (!*has) {
+                continue;
+            }
+
+            // Not a directory, so it cannot contain the rest of the path.
+            if (git_tree_lookup(&tree, repo, id) != GIT_OK) {
+                *has = false;
+                continue;
+            }
+
+            const git_tree_entry *entry = git_tree_entry_byname(tree, name.c_str());
+            if (entry != nullptr) {
+                *id = *git_tree_entry_id(entry);
+            } else {
+                *has = false;
+            }
+            git_tree_free(tree);
+        }
+    }
+}
+
+// Append every path that differs between two trees, including the directories leading to
+// each change. Subtrees with the same object ID on both sides are skipped without loading.
+// Returns `false` once more than `limit` paths have been collected.
+static bool collectChanges(git_repository *repo, const git_oid *oldTree, const git_oid *newTree,
+                           const std::string &prefix, std::vector<std::string> &paths,
+                           size_t limit)
+{
+    git_tree *trees[2] = { nullptr, nullptr };
+    const git_oid *ids[2] = { oldTree, newTree };
+    bool ok = true;
+
+    if (oldTree != nullptr && newTree != nullptr && git_oid_equal(oldTree, newTree)) {
+        return true;
+    }
+
+    for (int side = 0; side < 2; side++) {
+        if (ids[side] != nullptr && git_tree_lookup(&trees[side], repo, ids[side]) != GIT_OK) {
+            trees[side] = nullptr;
+        }
+    }
+
+    for (int side = 0; side < 2 && ok; side++) {
+        git_tree *tree = trees[side];
+        git_tree *other = trees[1 - side];
+        const size_t count = tree == nullptr ? 0 : git_tree_entrycount(tree);
+
+        for (size_t i = 0; i < count && ok; i++) {
+            const git_tree_entry *entry = git_tree_entry_byindex(tree, i);
+            const char *name = git_tree_entry_name(entry);
+            const git_tree_entry *match
+                    = other == nullptr ? nullptr : git_tree_entry_byname(other, name);
+
+            // Entries present on both sides are handled once, from the new tree.
+            if (match != nullptr && side == 0) {
+                continue;
+            }
+            if (match != nullptr
+                && git_oid_equal(git_tree_entry_id(entry), git_tree_entry_id(match))) {
+                continue;
+            }
+
+            const std::string path = prefix + name;
+            paths.push_back(path);
+            if (paths.size() > limit) {
+                ok = false;
+                break;
+            }
+
+            const bool isTree = git_tree_entry_type(entry) == GIT_OBJECT_TREE;
+            const bool matchIsTree
+                    = match != nullptr && git_tree_entry_type(match) == GIT_OBJECT_TREE;
+            if (isTree || matchIsTree) {
+                const git_oid *entryId = isTree ? git_tree_entry_id(entry) : nullptr;
+                const git_oid *matchId = matchIsTree ? git_tree_entry_id(match) : nullptr;
+                const git_oid *oldId = side == 0 ? entryId : matchId;
+                const git_oid *newId = side == 0 ? matchId : entryId;
+                ok = collectChanges(repo, oldId, newId, path + "/", paths, limit);
+            }
+        }
+    }
+
+    git_tree_free(trees[0]);
+    git_tree_free(trees[1]);
+
+    return ok;
+}
+
+// Changed-path filter of a commit that is not in the index yet.
+static BloomFilter changedPathFilter(git_repository *repo, git_commit *commit)
+{
+    std::vector<std::string> paths;
+    git_commit *parent = nullptr;
+    const git_oid *parentTree = nullptr;
+
+    if (git_commit_parentcount(commit) > 0 && git_commit_parent(&parent, commit, 0) == GIT_OK) {
+        parentTree = git_commit_tree_id(parent);
+    }
+
+    const bool complete = collectChanges(repo, parentTree, git_commit_tree_id(commit), "", paths,
+                                         BloomFilter::MaxChangedPaths);
+    git_commit_free(parent);
+
+    return complete ? BloomFilter::fromPaths(paths) : BloomFilter();
+}
+
+// Like `git log -- <path>`: a commit is kept unless it matches one of its parents at the path.
+bool GitRepository::touchesPath(git_repository *repo, git_commit *commit) const
+{
+    const git_oid *tree = git_commit_tree_id(commit);
+    unsigned int parents = git_commit_parentcount(commit);
+
+    if (parents == 0) {
+        return pathChanged(repo, nullptr, tree, m_pathFilter);
+    }
+
+    if (m_walkMode == WalkMode::FirstParent) {
+        parents = 1;
+    }
+
+    for (unsigned int i = 0; i < parents; i++) {
+        git_commit *parent = nullptr;
+
+        if (git_commit_parent(&parent, commit, i) != GIT_OK) {
+            continue;
+        }
+
+        const bool changed = pathChanged(repo, git_commit_tree_id(parent), tree, m_pathFilter);
+        git_commit_free(parent);
+
+        if (!changed) {
+            return false;
+        }
+    }
 
     return true;
 }
@@ -317,6 +992,341 @@ bool GitRepository::parseRemotes()
     return true;
 }
 
+// Patch ID of a commit against its parent. Merges and commits without changes get a zero ID:
+// neither has one change that a cherry-pick could repeat.
+static bool commitPatchId(git_repository *repo, const git_oid *id, git_oid *out)
+{
+    git_commit *commit = nullptr;
+    git_commit *parent = nullptr;
+    git_tree *tree = nullptr;
+    git_tree *parentTree = nullptr;
+    git_diff *diff = nullptr;
+    bool ok = git_commit_lookup(&commit, repo, id) == GIT_OK;
+
+    std::memset(out, 0, sizeof(*out));
+
+    if (ok && git_commit_parentcount(commit) > 1) {
+        git_commit_free(commit);
+        return true;
+    }
+
+    ok = ok && git_commit_tree(&tree, commit) == GIT_OK;
+    if (ok && git_commit_parentcount(commit) == 1) {
+        ok = git_commit_parent(&parent, commit, 0) == GIT_OK
+                && git_commit_tree(&parentTree, parent) == GIT_OK;
+    }
+    ok = ok && git_diff_tree_to_tree(&diff, repo, parentTree, tree, nullptr) == GIT_OK;
+    if (ok && git_diff_num_deltas(diff) > 0) {
+        ok = git_diff_patchid(out, diff, nullptr) == GIT_OK;
+    }
+
+    git_diff_free(diff);
+    git_tree_free(parentTree);
+    git_tree_free(tree);
+    git_commit_free(parent);
+    git_commit_free(commit);
+    return ok;
+}
+
+void GitRepository::computePatchIds(Commits &commits)
+{
+    TraceSpan span("patch-ids", "git");
+
+    // Loaded once; update() then only adds the new commits.
+    if (m_patchIds.size() == 0) {
+        m_patchIds.load(std::filesystem::path(git_repository_path(m_repo)) / "standard-release"
+                        / "patch-ids");
+    }
+
+    std::vector<Commit *> missing;
+    std::vector<git_oid> ids;
+    char hex[GIT_OID_HEXSZ + 1] = { 0 };
+
+    for (auto &commit : commits) {
+        git_oid oid;
+        git_oid patchId;
+        if (git_oid_fromstr(&oid, commit.id.c_str()) != GIT_OK) {
+            continue;
+        }
+
+        const unsigned char *cached = m_patchIds.find(oid.id);
+        if (cached == nullptr) {
+            missing.push_back(&commit);
+            ids.push_back(oid);
+        } else {
+            git_oid_fromraw(&patchId, cached);
+            if (!git_oid_is_zero(&patchId)) {
+                commit.patchId = git_oid_tostr(hex, sizeof(hex), &patchId);
+            }
+        }
+    }
+
+    span.setDetail(std::to_string(missing.size()) + " diffs, "
+                   + std::to_string(commits.size() - missing.size()) + " cached");
+    if (missing.empty()) {
+        return;
+    }
+
+    // Repository handles are not shared between threads; every task opens its own.
+    const std::string path = git_repository_path(m_repo);
+    std::vector<git_oid> patchIds(missing.size());
+    std::vector<char> computed(missing.size(), 0);
+    auto &scheduler = TaskScheduler::global();
+    const size_t grain = std::max<size_t>(16, missing.size() / (scheduler.workerCount() * 4));
+
+    parallelFor(scheduler, missing.size(), grain, [&](size_t begin, size_t end) {
+        git_repository *repo = nullptr;
+        if (git_repository_open(&repo, path.c_str()) != GIT_OK) {
+            return;
+        }
+        for (size_t i = begin; i < end; i++) {
+            computed[i] = commitPatchId(repo, &ids[i], &patchIds[i]);
+        }
+        git_repository_free(repo);
+    });
+
+    for (size_t i = 0; i < missing.size(); i++) {
+        if (!computed[i]) {
+            continue;
+        }
+        m_patchIds.insert(ids[i].id, patchIds[i].id);
+        if (!git_oid_is_zero(&patchIds[i])) {
+            missing[i]->patchId = git_oid_tostr(hex, sizeof(hex), &patchIds[i]);
+        }
+    }
+
+    m_patchIds.save();
+}
+
+// A commit read by decodeCommits().
+struct GitRepository::DecodedCommit
+{
+    /** Passed the path filter. */
+    bool keep = false;
+    /** `filter` is new and belongs in the changed-path index. */
+    bool indexed = false;
+    BloomFilter filter;
+    std::string message;
+};
+
+// Look up and decode commits with `repo`, which belongs to the calling thread. Only reads the
+// members, so chunks of a walk can be decoded in parallel.
+void GitRepository::decodeCommits(git_repository *repo, const git_oid *ids, size_t count,
+                                  DecodedCommit *decoded) const
+{
+    const bool usePathIndex = m_usePathIndex && !m_pathFilter.empty();
+    const int64_t begin = Tracer::now();
+
+    for (size_t i = 0; i < count; i++) {
+        DecodedCommit &out = decoded[i];
+        git_commit *commit = nullptr;
+
+        if (git_commit_lookup(&commit, repo, &ids[i]) != GIT_OK) {
+            continue;
+        }
+
+        // Indexed commits were filtered before decoding; the rest are indexed now.
+        if (usePathIndex && m_pathIndex.find(ids[i].id) == nullptr) {
+            out.filter = changedPathFilter(repo, commit);
+            out.indexed = true;
+            if (!out.filter.contains(m_pathFilter)) {
+                git_commit_free(commit);
+                continue;
+            }
+        }
+
+        if (!m_pathFilter.empty() && !touchesPath(repo, commit)) {
+            git_commit_free(commit);
+            continue;
+        }
+
+        // git_commit_summary() and git_commit_body() would each make a copy; the message is
+        // copied once and split later.
+        out.message = git_commit_message(commit);
+        out.keep = true;
+
+        git_commit_free(commit);
+    }
+
+    Tracer::global().record("decode", "git", begin, Tracer::now(),
+                            std::to_string(count) + " commits");
+}
+
+// Apply the walk mode. git_revwalk_reset() clears it, so this is repeated after every reset.
+void GitRepository::configureWalk(git_revwalk *walker) const
+{
+    switch (m_walkMode) {
+        case WalkMode::Topological:
+            git_revwalk_sorting(walker, GIT_SORT_TOPOLOGICAL);
+            break;
+        case WalkMode::Time:
+            git_revwalk_sorting(walker, GIT_SORT_TIME);
+            break;
+        case WalkMode::FirstParent:
+        case WalkMode::Default:
+        default:
+            git_revwalk_sorting(walker, GIT_SORT_NONE);
+            break;
+    }
+
+    if (m_walkMode == WalkMode::FirstParent) {
+        git_revwalk_simplify_first_parent(walker);
+    }
+}
+
+// Decode every commit a walk returns that passes the path filter, in walk order.
+bool GitRepository::readCommits(git_revwalk *walker, Commits &commits)
+{
+    git_oid oid;
+    std::vector<git_oid> ids;
+
+    // Built once per parse or update; abbreviations are then a binary search per commit.
+    if (m_oids.empty()) {
+        m_oids.build(m_repo);
+    }
+
+    const bool usePathIndex = m_usePathIndex && !m_pathFilter.empty();
+    if (usePathIndex) {
+        m_pathIndex.load(std::filesystem::path(git_repository_path(m_repo)) / "standard-release"
+                         / "changed-paths");
+    }
+
+    // The walk itself only yields IDs and is cheap; inflating the commits is not.
+    const int64_t walkBegin = Tracer::now();
+    while (git_revwalk_next(&oid, walker) == GIT_OK) {
+        Stats::add(Stats::CommitsWalked);
+
+        // Indexed commits that cannot match are skipped before they are even decoded.
+        if (usePathIndex) {
+            const BloomFilter *filter = m_pathIndex.find(oid.id);
+            if (filter != nullptr && !filter->contains(m_pathFilter)) {
+                continue;
+            }
+        }
+
+        ids.push_back(oid);
+    }
+    Tracer::global().record("revwalk", "git", walkBegin, Tracer::now(),
+                            std::to_string(ids.size()) + " commits");
+
+    // Repository handles are not shared between threads; every chunk opens its own. Short
+    // walks are not worth the extra handles.
+    std::vector<DecodedCommit> decoded(ids.size());
+    auto &scheduler = TaskScheduler::global();
+    const size_t parallelMin = 512;
+
+    if (ids.size() < parallelMin || scheduler.workerCount() < 2) {
+        decodeCommits(m_repo, ids.data(), ids.size(), decoded.data());
+    } else {
+        const std::string path = git_repository_path(m_repo);
+        const size_t grain = std::max<size_t>(256, ids.size() / (scheduler.workerCount() * 4));
+        std::atomic<bool> failed(false);
+
+        parallelFor(scheduler, ids.size(), grain, [&](size_t begin, size_t end) {
+            git_repository *handle = nullptr;
+            if (git_repository_open(&handle, path.c_str()) != GIT_OK) {
+                failed = true;
+                return;
+            }
+            const std::unique_ptr<git_repository, decltype(&git_repository_free)> repo(
+                    handle, git_repository_free);
+            decodeCommits(repo.get(), ids.data() + begin, end - begin, decoded.data() + begin);
+        });
+
+        if (failed) {
+            m_error = Error(Error::ErrorOpeningGitRepo, path);
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < ids.size(); i++) {
+        DecodedCommit &commit = decoded[i];
+        char sha1[GIT_OID_HEXSZ + 1] = { 0 };
+        char id[GIT_OID_HEXSZ + 1] = { 0 };
+
+        if (commit.indexed) {
+            m_pathIndex.insert(ids[i].id, commit.filter);
+        }
+        if (!commit.keep) {
+            continue;
+        }
+
+        git_oid_tostr(sha1, m_oids.abbrevLength(ids[i].id) + 1, &ids[i]);
+        git_oid_tostr(id, sizeof(id), &ids[i]);
+
+        Stats::add(Stats::CommitsDecoded);
+        commits.push_back(Commit::fromMessage(std::move(commit.message), sha1, id));
+        srDebug(lcGit()) << sha1 << ' ' << commits.back().summary();
+    }
+
+    if (usePathIndex) {
+        m_pathIndex.save();
+    }
+
+    return true;
+}
+
+bool GitRepository::update(Commits &added)
+{
+    TraceSpan span("update", "git");
+
+    git_oid head;
+    git_oid previous;
+    git_revwalk *walker = nullptr;
+    char id[GIT_OID_HEXSZ + 1] = { 0 };
+
+    added.clear();
+
+    if (!m_open || m_headId.empty()) {
+        m_error = Error(Error::InternalError, "update() called before parse()");
+        return false;
+    }
+
+    if (git_reference_name_to_id(&head, m_repo, "HEAD") != GIT_OK
+        || git_oid_fromstr(&previous, m_headId.c_str()) != GIT_OK) {
+        m_error = Error(Error::InternalError, git2error());
+        return false;
+    }
+
+    if (git_oid_equal(&head, &previous)) {
+        return true;
+    }
+
+    if (git_graph_descendant_of(m_repo, &head, &previous) != 1) {
+        m_error = Error(Error::InternalError, "HEAD no longer contains " + m_headId);
+        return false;
+    }
+
+    if (git_revwalk_new(&walker, m_repo) != GIT_OK) {
+        m_error = Error(Error::InternalError, "error traversing git repo");
+        return false;
+    }
+
+    configureWalk(walker);
+    git_revwalk_push(walker, &head);
+    git_revwalk_hide(walker, &previous);
+
+    // The index only knows the objects that existed when it was built; the new commits come
+    // with new trees and blobs, so readCommits() builds it again.
+    m_oids.clear();
+
+    const bool read = readCommits(walker, added);
+    git_revwalk_free(walker);
+    if (!read) {
+        return false;
+    }
+
+    if (m_detectDuplicates) {
+        computePatchIds(added);
+    }
+
+    m_headId = git_oid_tostr(id, sizeof(id), &head);
+    m_commits.insert(m_commits.begin(), added.begin(), added.end());
+    srInfo(lcGit()) << "found " << added.size() << " new commits";
+
+    return true;
+}
+
 bool GitRepository::parse(const std::string beginFrom)
 {
     int ret;
@@ -335,13 +1345,16 @@ bool GitRepository::parse(const std::string beginFrom)
         return false;
     }
 
+    m_commits.clear();
+    m_headId.clear();
+
     ret = git_revwalk_new(&walker, m_repo);
     if (ret != GIT_OK) {
         m_error = Error(Error::InternalError, "error traversing git repo");
         return false;
     }
 
-    git_revwalk_sorting(walker, GIT_SORT_NONE);
+    configureWalk(walker);
 
     ret = git_revparse_single(&rev, m_repo, fromStr.c_str());
     if (ret != GIT_OK) {
@@ -365,51 +1378,48 @@ bool GitRepository::parse(const std::string beginFrom)
         if (ret != GIT_OK) {
             m_error = Error(Error::InternalError,
                             "invalid git range requested (" + range.str() + ")");
+            git_revwalk_free(walker);
             return false;
         }
     }
 
-    while (git_revwalk_next(&oid, walker) == GIT_OK) {
-        git_commit *commit = nullptr;
-        char sha1[8] = { 0 };
+    if (git_reference_name_to_id(&oid, m_repo, "HEAD") == GIT_OK) {
+        char head[GIT_OID_HEXSZ + 1] = { 0 };
+        m_headId = git_oid_tostr(head, sizeof(head), &oid);
+    }
 
-        git_commit_lookup(&commit, m_repo, &oid);
-        git_oid_tostr(sha1, sizeof(sha1), &oid);
+    const bool read = readCommits(walker, m_commits);
 
-        const char *summary = git_commit_summary(commit);
-        const char *body = git_commit_body(commit);
+    git_revwalk_free(walker);
+    if (!read) {
+        // Without its commits the parse is not a base that update() can build on.
+        m_headId.clear();
+        return false;
+    }
 
-        if (body == nullptr) {
-            m_commits.push_back(Commit(summary, "", sha1));
-        } else {
-            m_commits.push_back(Commit(summary, body, sha1));
-        }
+    srInfo(lcGit()) << "found " << m_commits.size() << " commits"
+                    << (fromStr.empty() ? std::string() : " since " + fromStr);
 
-        git_commit_free(commit);
+    if (m_detectDuplicates) {
+        computePatchIds(m_commits);
     }
 
-    git_revwalk_free(walker);
-
     parseRemotes();
 
+    // Without a recognized `origin` the changelog has no links, but the history is still read.
     // TODO: Do not hardcode origin.
     ret = git_remote_lookup(&remote, m_repo, "origin");
     if (ret != GIT_OK) {
-        m_error = Error(Error::InternalError, git2error());
-        return false;
+        srDebug(lcGit()) << "no origin: " << git2error();
+        return true;
     }
 
     m_remoteUrl = git_remote_url(remote);
-    // const char *name = git_remote_name(remote);
-
-    {
-        // Extract baseUrl.
-        std::regex_search(m_remoteUrl, match, std::regex(remoteRegex));
-        if (match.empty()) {
-            // setError(Error::InternalError);
-            return false;
-        }
+    git_remote_free(remote);
 
+    // Extract baseUrl.
+    std::regex_search(m_remoteUrl, match, std::regex(remoteRegex));
+    if (!match.empty()) {
         std::string host = match[1];
         std::string repo = match[2];
 
@@ -420,8 +1430,6 @@ bool GitRepository::parse(const std::string beginFrom)
         m_url = "https://" + host + "/" + repo;
     }
 
-    git_remote_free(remote);
-
     return true;
 }
 
@@ -429,6 +1437,8 @@ bool GitRepository::parse(const std::string beginFrom)
 
 bool GitRepository::commit(const std::string &msg)
 {
+    TraceSpan span("commit", "git");
+
     int ret = 0;
     git_object *parent = nullptr;
     git_reference *ref = nullptr;
@@ -439,30 +1449,79 @@ bool GitRepository::commit(const std::string &msg)
     git_signature *signature = nullptr;
     const char *glob = ".";
     const git_strarray pathspec = { (char **)&glob, 1 };
+    std::string branch;
 
     auto cb = [](const char *path, const char *matched_pathspec, void *payload) {
         // Add all changed files.
         return 0;
     };
 
-    ret = git_revparse_ext(&parent, &ref, m_repo, "HEAD");
-    ret = git_repository_index(&index, m_repo);
-    ret = git_index_add_all(index, &pathspec, GIT_INDEX_ADD_DEFAULT, cb, nullptr);
-    ret = git_index_write_tree(&tree_oid, index);
-    git_index_write(index);
+    if (m_batch != nullptr) {
+        branch = headName();
+    }
 
-    ret = git_tree_lookup(&tree, m_repo, &tree_oid);
+    if (m_batch != nullptr && m_batch->hasHead) {
+        ret = git_object_lookup(&parent, m_repo, &m_batch->head, GIT_OBJECT_COMMIT);
+    } else {
+        ret = git_revparse_ext(&parent, &ref, m_repo, "HEAD");
+    }
 
-    ret = git_signature_default(&signature, m_repo);
-    ret = git_commit_create_v(&commit_oid, m_repo, "HEAD", signature, signature, nullptr,
-                              msg.c_str(), tree, 1, parent);
+    ret = git_repository_index(&index, m_repo);
+    if (ret == GIT_OK) {
+        ret = git_index_add_all(index, &pathspec, GIT_INDEX_ADD_DEFAULT, cb, nullptr);
+    }
+    if (ret == GIT_OK) {
+        ret = git_index_write_tree(&tree_oid, index);
+    }
+    if (ret == GIT_OK) {
+        ret = git_index_write(index);
+    }
+    if (ret == GIT_OK) {
+        ret = git_tree_lookup(&tree, m_repo, &tree_oid);
+    }
     if (ret != GIT_OK) {
-        throw Exception("Error commiting release");
+        m_error = Error(Error::GitWriteFailed, git2error());
+    }
+
+    if (ret == GIT_OK) {
+        ret = git_signature_default(&signature, m_repo);
+        if (ret != GIT_OK) {
+            m_error = Error(Error::GitBadSignature,
+                            "No git identity configured (user.name and user.email)");
+        }
+    }
+
+    // In batch mode the branch is moved by commitBatch() instead.
+    if (ret == GIT_OK) {
+        ret = git_commit_create_v(&commit_oid, m_repo, m_batch != nullptr ? nullptr : "HEAD",
+                                  signature, signature, nullptr, msg.c_str(), tree, 1, parent);
+        if (ret != GIT_OK) {
+            m_error = Error(Error::GitWriteFailed, git2error());
+        }
+    }
+
+    if (ret == GIT_OK && m_batch != nullptr) {
+        if (!m_batch->hasHead && parent != nullptr) {
+            m_batch->base = *git_object_id(parent);
+            m_batch->hasBase = true;
+        }
+        m_batch->head = commit_oid;
+        m_batch->hasHead = true;
+
+        auto queued = std::find_if(m_batch->refs.begin(), m_batch->refs.end(),
+                                   [&branch](const auto &ref) { return ref.first == branch; });
+        if (queued != m_batch->refs.end()) {
+            queued->second = commit_oid;
+        } else {
+            m_batch->refs.push_back({ branch, commit_oid });
+        }
     }
 
     git_index_free(index);
     git_signature_free(signature);
     git_tree_free(tree);
+    git_object_free(parent);
+    git_reference_free(ref);
 
-    return true;
+    return ret == GIT_OK;
 }
@@ -1,17 +1,27 @@
 #pragma once
 
 #include "standard-release/errors/errors.h"
+#include "standard-release/git/bloom.h"
+#include "standard-release/git/oidindex.h"
+#include "standard-release/git/patchid.h"
 #include "standard-release/global/global.h"
+#include <cstdint>
 #include <filesystem>
 #include <list>
 #include <string>
+#include <string_view>
 #include <vector>
 
 // TODO: hide when GitRepoPrivate is implemented.
 struct git_repository;
+struct git_commit;
+struct git_revwalk;
+struct git_oid;
 
 namespace StandardRelease {
 
+struct GitBatch;
+
 /**
  * @brief Interface for a Git repository.
  */
@@ -23,26 +33,137 @@ public:
 
     static bool isRepo(const std::string &dirName);
 
+    /**
+     * @brief A commit read from the history.
+     * @details The message is kept whole, as stored in the commit; the summary and body are views
+     * into it, located by offsets. The body is only trimmed when it is asked for.
+     */
     struct Commit
     {
-        std::string summary;
-        std::string body;
+        /** Shortest unique abbreviation of the commit ID. */
         std::string hash;
+        /** Full commit ID. */
+        std::string id;
+        /** Patch ID (see setDetectDuplicates()); empty if unknown or for merges. */
+        std::string patchId;
+
+        /** Create a commit from its summary and body. */
+        Commit(const char *summary, const char *body = "", const char *hash = "",
+               const char *id = "");
+
+        /** Create a commit from its full message. */
+        static Commit fromMessage(std::string message, const char *hash = "",
+                                  const char *id = "");
+
+        /** Full message. */
+        const std::string &message() const { return m_message; }
+
+        /** First paragraph of the message, on one line. */
+        std::string_view summary() const
+        {
+            return std::string_view(m_message).substr(m_summaryOffset, m_summaryLength);
+        }
+
+        /** Message without the summary, with surrounding whitespace removed. */
+        std::string_view body() const;
 
-        Commit(const char *str1, const char *str2 = "", const char *str3 = "")
-            : summary(str1)
-            , body(str2)
-            , hash(str3) {};
+    private:
+        void index();
+
+        std::string m_message;
+        uint32_t m_summaryOffset = 0;
+        uint32_t m_summaryLength = 0;
+        uint32_t m_bodyOffset = 0;
     };
 
     using Commits = std::list<GitRepository::Commit>;
 
+    /**
+     * @brief Statistics gathered by the most recent push.
+     */
+    struct PushStats
+    {
+        /** Number of refspecs sent in the push. */
+        size_t refs = 0;
+        /** Commits ahead of the upstream branch before pushing. */
+        int ahead = 0;
+        /** Milliseconds until the remote finished negotiating ref updates. */
+        double negotiationMs = 0;
+        /** Milliseconds for the entire push. */
+        double totalMs = 0;
+        /** Objects sent in the packfile. */
+        unsigned int objects = 0;
+        /** Bytes sent in the packfile. */
+        size_t bytes = 0;
+    };
+
+    /**
+     * @brief How parse() traverses history.
+     */
+    enum WalkMode
+    {
+        /** Every parent of every commit, in libgit2's default order. */
+        Default,
+        /** Only the first parent of each merge, skipping the commits inside merged branches. */
+        FirstParent,
+        /** Parents are never visited before all of their children. */
+        Topological,
+        /** Newest commit time first. */
+        Time,
+    };
+
     /** Most recent error. */
     Error error() const;
 
+    /** Walk mode with a name (`default`, `first-parent`, `topological` or `time`). */
+    static bool walkModeFromName(const std::string &name, WalkMode &mode);
+
+    /** Current walk mode. */
+    WalkMode walkMode() const;
+
+    /** Set the walk mode used by parse(). */
+    void setWalkMode(WalkMode mode);
+
+    /** Path that commits must touch to be returned by parse(). */
+    std::string pathFilter() const;
+
+    /**
+     * @brief Only return commits that changed a path.
+     * @param[in] path File or directory relative to the repository root. Empty to disable.
+     */
+    void setPathFilter(const std::string &path);
+
+    /** Is the changed-path index used by path-filtered walks? */
+    bool pathIndex() const;
+
+    /**
+     * @brief Use a persistent changed-path Bloom filter index for path-filtered walks.
+     * @details Commits whose filter rules out the path are skipped without loading any trees.
+     * The index is kept in `.git/standard-release/changed-paths` and every walk adds the commits
+     * that are not indexed yet.
+     */
+    void setPathIndex(bool enabled);
+
+    /** Are patch IDs computed by parse()? */
+    bool detectDuplicates() const;
+
+    /**
+     * @brief Compute the patch ID of every commit returned by parse().
+     * @details Commits with the same patch ID (e.g. a change and its cherry-picks) make the same
+     * change. Diffs are computed in parallel on the global TaskScheduler and cached in
+     * `.git/standard-release/patch-ids`, so only new commits are diffed on later runs.
+     */
+    void setDetectDuplicates(bool enabled);
+
     /** List of commits. */
     Commits commits() const;
 
+    /** Full ID of the `HEAD` commit read by the last parse() or update(). */
+    std::string headId() const;
+
+    /** Full ID of the commit `HEAD` points to now, or an empty string if there is none. */
+    std::string currentHeadId() const;
+
     /** Remote origin URL. */
     std::string remoteUrl() const;
 
@@ -67,6 +188,17 @@ public:
      */
     bool push(const std::string &name);
 
+    /**
+     * @brief Push several refs (e.g. a branch and its release tags) in a single push.
+     * @details All refspecs share one remote connection and one negotiation.
+     * @param[in] names Full reference names (e.g. `refs/tags/v1.0.0`).
+     * @returns `true` if successful. Otherwise, `error()` will return an error description.
+     */
+    bool push(const std::vector<std::string> &names);
+
+    /** Statistics from the most recent push. */
+    PushStats pushStats() const;
+
     /**
      * @brief Create a release.
      * @param[in] version Release version.
@@ -74,11 +206,49 @@ public:
      */
     bool createRelease(const std::string &version);
 
+    /**
+     * @brief Create a release with several tags (e.g. one per package).
+     * @details The release commit and every tag are written in a single batch, then pushed
+     * together with the current branch.
+     * @param[in] message Commit and tag message.
+     * @param[in] tags Names of the tags to create.
+     * @returns `true` if successful. Otherwise, `error()` will return an error description.
+     */
+    bool createRelease(const std::string &message, const std::vector<std::string> &tags);
+
+    /**
+     * @brief Start buffering object and ref writes.
+     * @details Until commitBatch() is called, objects created by commit() and createTag() are
+     * kept in an in-memory object database and their ref updates are queued.
+     * @returns `true` if successful. Otherwise, `error()` will return an error description.
+     */
+    bool beginBatch();
+
+    /**
+     * @brief Write all buffered objects as one packfile and apply all queued ref updates in a
+     * single ref transaction.
+     * @returns `true` if successful. Otherwise, `error()` will return an error description.
+     */
+    bool commitBatch();
+
     /**
      * @brief Parse an opened git repository.
+     * @details A missing or unrecognized `origin` only leaves url() empty.
+     * @returns `true` if the history was read. Otherwise, `error()` will return an error
+     * description.
      */
     bool parse(const std::string beginFrom);
 
+    /**
+     * @brief Read the commits made since the last parse() or update().
+     * @details Walks from `HEAD` down to the previous `HEAD`, with the same walk mode, path
+     * filter and patch IDs as parse(), and adds the new commits to the front of commits().
+     * @param[out] added The new commits, newest first; empty if `HEAD` has not moved.
+     * @returns `false` if the previous `HEAD` is no longer part of the history (e.g. after a
+     * reset or rebase) or on error; parse() must then be called again.
+     */
+    bool update(Commits &added);
+
     bool createTag(const std::string &name, const std::string msg);
 
 private:
@@ -86,14 +256,41 @@ private:
 
     int countUnpushed();
 
+    std::string headName();
+
+    bool touchesPath(git_repository *repo, git_commit *commit) const;
+
+    void abortBatch();
+
+    void configureWalk(git_revwalk *walker) const;
+
+    bool readCommits(git_revwalk *walker, Commits &commits);
+
+    struct DecodedCommit;
+
+    void decodeCommits(git_repository *repo, const git_oid *ids, size_t count,
+                       DecodedCommit *decoded) const;
+
+    void computePatchIds(Commits &commits);
+
     Error m_error;
     struct git_repository *m_repo;
     bool m_open;
     Commits m_commits;
+    std::string m_headId;
     std::filesystem::path m_dirname;
     std::string m_remoteUrl;
     std::string m_url;
     std::vector<std::string> m_remotes;
+    PushStats m_pushStats;
+    OidIndex m_oids;
+    WalkMode m_walkMode;
+    std::string m_pathFilter;
+    bool m_usePathIndex;
+    ChangedPathIndex m_pathIndex;
+    bool m_detectDuplicates;
+    PatchIdCache m_patchIds;
+    GitBatch *m_batch;
 };
 
 }
@@ -0,0 +1,234 @@
+#include "async.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+using namespace StandardRelease;
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief One message in the ring.
+ * @details `sequence` is the slot's turn counter (Vyukov's bounded MPMC queue): equal to the
+ * ring position when free, position + 1 once published, position + capacity once consumed.
+ */
+struct alignas(64) LogSlot
+{
+    std::atomic<size_t> sequence;
+    Clock::time_point time;
+    ILogger::Level level;
+    const LogCategory *category;
+    size_t length;
+    char text[LogMessage::MaxLength];
+};
+
+struct StandardRelease::AsyncLoggerPrivate
+{
+    std::FILE *out;
+    std::unique_ptr<LogSlot[]> ring;
+    size_t mask;
+    Clock::time_point start;
+
+    alignas(64) std::atomic<size_t> enqueuePos { 0 };
+    alignas(64) std::atomic<size_t> dequeuePos { 0 };
+    std::atomic<size_t> dropped { 0 };
+
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable drained;
+    std::atomic<bool> sleeping { false };
+    std::atomic<bool> stopping { false };
+
+    bool push(ILogger::Level level, const LogCategory &category, std::string_view message)
+    {
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        LogSlot *slot = nullptr;
+
+        while (true) {
+            slot = &ring[pos & mask];
+            const size_t seq = slot->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->time = Clock::now();
+        slot->level = level;
+        slot->category = &category;
+        slot->length = std::min(message.length(), sizeof(slot->text));
+        std::memcpy(slot->text, message.data(), slot->length);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    void print(const LogSlot &slot)
+    {
+        const double seconds = std::chrono::duration<double>(slot.time - start).count();
+        std::fprintf(out, "[%10.6f] %s %s: %.*s\n", seconds, ILogger::levelName(slot.level),
+                     slot.category->name(), static_cast<int>(slot.length), slot.text);
+    }
+
+    bool hasMessages() const
+    {
+        const size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        return ring[pos & mask].sequence.load(std::memory_order_acquire) == pos + 1;
+    }
+
+    // Wake the background thread without racing its check of hasMessages().
+    void signal()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+        }
+        wake.notify_one();
+    }
+
+    // Only ever called from one thread at a time (the background thread, or the owner
+    // before open() / after the thread has stopped).
+    size_t drain()
+    {
+        size_t count = 0;
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+
+        while (true) {
+            LogSlot &slot = ring[pos & mask];
+            const size_t seq = slot.sequence.load(std::memory_order_acquire);
+            if (seq != pos + 1) {
+                break;
+            }
+
+            print(slot);
+            slot.sequence.store(pos + mask + 1, std::memory_order_release);
+            dequeuePos.store(++pos, std::memory_order_release);
+            count++;
+        }
+
+        if (count > 0) {
+            std::fflush(out);
+            std::lock_guard<std::mutex> lock(mutex);
+            drained.notify_all();
+        }
+        return count;
+    }
+
+    void run()
+    {
+        while (true) {
+            if (drain() > 0) {
+                continue;
+            }
+            if (stopping.load(std::memory_order_acquire)) {
+                drain();
+                break;
+            }
+
+            // Writers signal without the mutex (and only while we sleep), so a wakeup can be
+            // missed; the timeout bounds how long such a message waits.
+            std::unique_lock<std::mutex> lock(mutex);
+            sleeping = true;
+            wake.wait_for(lock, std::chrono::milliseconds(10),
+                          [this] { return stopping || hasMessages(); });
+            sleeping = false;
+        }
+    }
+};
+
+static size_t roundUpToPowerOfTwo(size_t value)
+{
+    size_t result = 2;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+AsyncLogger::AsyncLogger(std::FILE *out, size_t capacity)
+    : d(new AsyncLoggerPrivate)
+{
+    capacity = roundUpToPowerOfTwo(capacity);
+
+    d->out = out;
+    d->ring = std::make_unique<LogSlot[]>(capacity);
+    d->mask = capacity - 1;
+    d->start = Clock::now();
+
+    for (size_t i = 0; i < capacity; i++) {
+        d->ring[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+AsyncLogger::~AsyncLogger()
+{
+    if (ILogger::instance() == this) {
+        ILogger::setInstance(nullptr);
+    }
+
+    if (d->thread.joinable()) {
+        d->stopping = true;
+        d->signal();
+        d->thread.join();
+    } else {
+        d->drain();
+    }
+
+    delete d;
+}
+
+void AsyncLogger::open()
+{
+    if (!d->thread.joinable()) {
+        d->thread = std::thread([this] { d->run(); });
+    }
+}
+
+void AsyncLogger::write(Level level, const LogCategory &category, std::string_view message)
+{
+    if (!d->push(level, category, message)) {
+        d->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (d->sleeping.load(std::memory_order_relaxed)) {
+        d->wake.notify_one();
+    }
+}
+
+void AsyncLogger::flush()
+{
+    if (!d->thread.joinable()) {
+        d->drain();
+        return;
+    }
+
+    const size_t target = d->enqueuePos.load(std::memory_order_acquire);
+    d->signal();
+
+    std::unique_lock<std::mutex> lock(d->mutex);
+    d->drained.wait(lock, [this, target] {
+        return d->dequeuePos.load(std::memory_order_acquire) >= target;
+    });
+}
+
+size_t AsyncLogger::dropped() const
+{
+    return d->dropped.load(std::memory_order_relaxed);
+}
+
+size_t AsyncLogger::capacity() const
+{
+    return d->mask + 1;
+}
@@ -0,0 +1,58 @@
+/**
+ * @file standard-release/log/async.h
+ * @brief Asynchronous logging backend.
+ */
+#pragma once
+
+#include "standard-release/global/global.h"
+#include "standard-release/log/ilog.h"
+#include <cstddef>
+#include <cstdio>
+#include <string_view>
+
+namespace StandardRelease {
+
+class AsyncLoggerPrivate;
+
+/**
+ * @brief Logger that hands messages to a background thread.
+ * @details Callers copy each formatted message into a bounded lock-free ring buffer and return
+ * immediately; a background thread drains the ring to the output stream. When the ring is full
+ * the message is dropped (and counted) rather than blocking the caller.
+ */
+class STANDARDRELEASE_EXPORT AsyncLogger : public ILogger
+{
+public:
+    /**
+     * @brief Create a logger writing to `out`.
+     * @param out Destination stream (not closed by the logger).
+     * @param capacity Number of messages the ring can hold; rounded up to a power of two.
+     */
+    explicit AsyncLogger(std::FILE *out = stderr, size_t capacity = 8192);
+
+    /** Write every queued message and stop the background thread. */
+    ~AsyncLogger();
+
+    /**
+     * @brief Start the background thread.
+     * @note Messages written before open() are queued (up to the capacity of the ring).
+     */
+    void open();
+
+    /** Queue a message. Never blocks. */
+    void write(Level level, const LogCategory &category, std::string_view message);
+
+    /** Wait until every queued message has been written. */
+    void flush();
+
+    /** Number of messages dropped because the ring was full. */
+    size_t dropped() const;
+
+    /** Number of messages the ring can hold. */
+    size_t capacity() const;
+
+private:
+    AsyncLoggerPrivate *d;
+};
+
+}
@@ -0,0 +1,149 @@
+#include "ilog.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+using namespace StandardRelease;
+
+static std::atomic<ILogger *> globalLogger { nullptr };
+
+struct StandardRelease::ILoggerPrivate
+{
+    Error error;
+};
+
+ILogger::ILogger()
+    : d(new ILoggerPrivate)
+    , m_level(Info)
+{
+}
+
+ILogger::~ILogger()
+{
+    delete d;
+}
+
+Error ILogger::error() const
+{
+    return d->error;
+}
+
+void ILogger::setError(const Error error)
+{
+    d->error = error;
+}
+
+ILogger::Level ILogger::level() const
+{
+    return static_cast<Level>(m_level.load(std::memory_order_relaxed));
+}
+
+void ILogger::setLevel(Level level)
+{
+    m_level = level;
+}
+
+void ILogger::flush() {}
+
+ILogger *ILogger::instance()
+{
+    return globalLogger.load(std::memory_order_acquire);
+}
+
+void ILogger::setInstance(ILogger *logger)
+{
+    globalLogger.store(logger, std::memory_order_release);
+}
+
+const char *ILogger::levelName(Level level)
+{
+    switch (level) {
+        case Debug:
+            return "debug";
+        case Info:
+            return "info";
+        case Warning:
+            return "warning";
+        case Critical:
+            return "critical";
+        case Off:
+        default:
+            return "off";
+    }
+}
+
+LogCategory::LogCategory(const char *name, ILogger::Level level)
+    : m_name(name)
+    , m_level(level)
+{
+}
+
+const char *LogCategory::name() const
+{
+    return m_name;
+}
+
+void LogCategory::setLevel(ILogger::Level level)
+{
+    m_level = level;
+}
+
+LogMessage::LogMessage(ILogger::Level level, const LogCategory &category)
+    : m_level(level)
+    , m_category(category)
+    , m_length(0)
+{
+}
+
+LogMessage::~LogMessage()
+{
+    ILogger *logger = ILogger::instance();
+    if (logger != nullptr) {
+        logger->write(m_level, m_category, std::string_view(m_buffer, m_length));
+    }
+}
+
+LogMessage &LogMessage::operator<<(std::string_view str)
+{
+    const size_t count = std::min(str.length(), MaxLength - m_length);
+    std::memcpy(m_buffer + m_length, str.data(), count);
+    m_length += count;
+    return *this;
+}
+
+LogMessage &LogMessage::operator<<(double value)
+{
+    char buf[32];
+    const int length = std::snprintf(buf, sizeof(buf), "%g", value);
+    return *this << std::string_view(buf, length > 0 ? length : 0);
+}
+
+LogCategory &StandardRelease::lcGit()
+{
+    static LogCategory category("git");
+    return category;
+}
+
+LogCategory &StandardRelease::lcCommits()
+{
+    static LogCategory category("commits");
+    return category;
+}
+
+LogCategory &StandardRelease::lcChangelog()
+{
+    static LogCategory category("changelog");
+    return category;
+}
+
+LogCategory &StandardRelease::lcRelease()
+{
+    static LogCategory category("release");
+    return category;
+}
+
+LogCategory &StandardRelease::lcDaemon()
+{
+    static LogCategory category("daemon");
+    return category;
+}
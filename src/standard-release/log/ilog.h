@@ -4,8 +4,12 @@
  */
 #pragma once
 
-#include <ostream>
+#include <atomic>
+#include <charconv>
+#include <cstddef>
 #include <string>
+#include <string_view>
+#include <type_traits>
 
 #include "standard-release/errors/errors.h"
 #include "standard-release/global/global.h"
@@ -13,208 +17,196 @@
 namespace StandardRelease {
 
 class ILoggerPrivate;
+class LogCategory;
 
 /**
  * @brief Interface for logging backends.
  *
- * A logging service decoupled from the backend.
+ * A logging service decoupled from the backend. Messages are written through the macros
+ * below (e.g. `srDebug(lcGit()) << "found " << count << " commits";`) to the logger
+ * installed with setInstance().
  */
 class STANDARDRELEASE_EXPORT ILogger
 {
 public:
-#if 0
     /**
-     * @brief Verbosity level.
-     * @note Verbosity::Debug prints all messages.
+     * @brief Severity of a message.
+     * @note A logger set to Level::Debug prints all messages.
      */
-    enum VerbosityLevel {
-        /** Print all messages. */
+    enum Level
+    {
+        /** Detailed diagnostics. */
         Debug,
-        /** Print all information, warning, and error messages. */
+        /** Progress of a normal run. */
         Info,
-        /** Print all warning and error messages. */
+        /** Something unexpected that did not stop the run. */
         Warning,
-        /** Print only error messages. */
-        Error
-    };
-
-    enum MessageType {};
-    enum Message {};
-    enum LogLevel {
+        /** The run cannot continue. */
+        Critical,
+        /** Print nothing. */
+        Off,
     };
 
-    // usbEntries() will only be called if driverUsb category is enabled
-    // qCDebug(driverUsb) << "devices: " << usbEntries();
-
-#endif
-
-    // https://doc.qt.io/qt-5/qtglobal.html#QtMessageHandler-typedef
-    // https://doc.qt.io/qt-5/qtglobal.html#qInstallMessageHandler
-    // https://doc.qt.io/qt-5/qmessagelogger.html
-    // https://stackoverflow.com/questions/17595957/operator-overloading-in-c-for-logging-purposes
-
     /**
      * @brief Construct an empty logger.
      */
     ILogger();
 
-    ILogger();
+    virtual ~ILogger();
 
     /** Current status. */
     Error error() const;
 
+    /** Messages below this level are discarded. */
+    Level level() const;
+
+    /** Set the lowest level that is written. */
+    void setLevel(Level level);
+
     /**
      * @brief Open the logging backend.
      */
     virtual void open() = 0;
 
     /**
-     * @brief Pipe to an output stream.
+     * @brief Write one formatted message.
+     * @details Called from any thread; implementations must be thread-safe.
      */
-    operator std::ostream() const;
+    virtual void write(Level level, const LogCategory &category, std::string_view message) = 0;
+
+    /** Wait until every message written so far has reached its destination. */
+    virtual void flush();
+
+    /** Logger receiving all messages, or `nullptr` if logging is disabled. */
+    static ILogger *instance();
 
     /**
-     * @brief Pipe input to the backend for formatted printing.
+     * @brief Install the global logger.
+     * @note The caller keeps ownership and must reset it before destroying the logger.
      */
-    template<typename T>
-    ILogger &operator<<(const T &input);
+    static void setInstance(ILogger *logger);
+
+    /** Human-readable name of a level. */
+    static const char *levelName(Level level);
 
 protected:
+    void setError(const Error error);
+
 private:
     ILoggerPrivate *d;
+    std::atomic<int> m_level;
+};
 
-#if 0
-
-// static ILogger* logger = new ILogger();
-
-// allows usage of both factory method and variable in qCX macros
-    QLoggingCategory &operator()() { return *this; }
-    const QLoggingCategory &operator()() const { return *this; }
-
-    void init(const char *category, QtMsgType severityLevel);
+/**
+ * @brief Named group of messages (e.g. `git`) with its own minimum level.
+ */
+class STANDARDRELEASE_EXPORT LogCategory
+{
+public:
+    /** Create a category that initially lets every level through. */
+    explicit LogCategory(const char *name, ILogger::Level level = ILogger::Debug);
 
-#    define qCDebug(category, ...)                                                                 \
-        for (bool qt_category_enabled = category().isDebugEnabled(); qt_category_enabled;          \
-             qt_category_enabled = false)                                                          \
-        QMessageLogger(QT_MESSAGELOG_FILE, QT_MESSAGELOG_LINE, QT_MESSAGELOG_FUNC,                 \
-                       category().categoryName())                                                  \
-                .debug(__VA_ARGS__)
+    /** Category name. */
+    const char *name() const;
 
-    void debug(const char *msg, ...) const Q_ATTRIBUTE_FORMAT_PRINTF(2, 3);
-    typedef const QLoggingCategory &(*CategoryFunction)();
+    /** Set the lowest level written for this category. */
+    void setLevel(ILogger::Level level);
 
-    void debug(const QLoggingCategory &cat, const char *msg, ...) const Q_ATTRIBUTE_FORMAT_PRINTF(3, 4);
-#    define qDebug QMessageLogger(QT_MESSAGELOG_FILE, QT_MESSAGELOG_LINE, QT_MESSAGELOG_FUNC).debug
+    /** Would a message at `level` be written? */
+    bool isEnabled(ILogger::Level level) const
+    {
+        const ILogger *logger = ILogger::instance();
+        return logger != nullptr && level >= m_level.load(std::memory_order_relaxed)
+                && level >= logger->level();
+    }
 
-    inline QDebug(QString *string) : stream(new Stream(string)) {}
-    inline QDebug &operator<<(QChar t) { putUcs4(t.unicode()); return maybeSpace(); }
+private:
+    const char *m_name;
+    std::atomic<int> m_level;
+};
 
-// This is global, outside the class
-template <class T>
-inline QDebug operator<<(QDebug debug, const QList<T> &list)
-{
-    return QtPrivate::printSequentialContainer(debug, "" /*for historical reasons*/, list);
-}
-template <class Key, class T>
-inline QDebug operator<<(QDebug debug, const QMap<Key, T> &map)
+/**
+ * @brief A single message being formatted.
+ * @details Formats into a fixed buffer on the stack (no allocation) and hands the result to
+ * the logger when destroyed. Messages longer than the buffer are truncated.
+ */
+class STANDARDRELEASE_EXPORT LogMessage
 {
-    const bool oldSetting = debug.autoInsertSpaces();
-    debug.nospace() << "QMap(";
-    for (typename QMap<Key, T>::const_iterator it = map.constBegin();
-         it != map.constEnd(); ++it) {
-        debug << '(' << it.key() << ", " << it.value() << ')';
-    }
-    debug << ')';
-    debug.setAutoInsertSpaces(oldSetting);
-    return debug.maybeSpace();
-}
+public:
+    /** Longest message, in bytes. */
+    static const size_t MaxLength = 240;
 
-#endif
+    LogMessage(ILogger::Level level, const LogCategory &category);
+    ~LogMessage();
 
-#if 0
-    /**
-     * @brief Returns the version major.
-     */
-    int major() const;
+    LogMessage(const LogMessage &) = delete;
+    LogMessage &operator=(const LogMessage &) = delete;
 
-    /**
-     * @brief Returns the version minor.
-     */
-    int minor() const;
+    LogMessage &operator<<(std::string_view str);
 
-    /**
-     * @brief Returns the version patch number.
-     */
-    int patch() const;
+    LogMessage &operator<<(const char *str)
+    {
+        return *this << std::string_view(str == nullptr ? "(null)" : str);
+    }
 
-    /**
-     * @brief Different ways to increment the version number.
-     */
-    enum Increment
+    LogMessage &operator<<(const std::string &str)
     {
-        /** Increment the major (`1.2.3` -> `2.0.0` ). */
-        Major,
-        /** Increment the minor (`1.2.1` -> `1.3.0` ). */
-        Minor,
-        /** Increment the patch (`1.2.0` -> `1.2.1` ). */
-        Patch,
-        /** No increment was applied. */
-        None,
-    };
+        return *this << std::string_view(str);
+    }
 
-    /**
-     * @brief Increment to the next specified version.
-     * @param[in] inc Which increment to apply.
-     */
-    void increment(Increment inc);
+    LogMessage &operator<<(char c)
+    {
+        return *this << std::string_view(&c, 1);
+    }
 
-    /**
-     * @brief Compares two versions to determine which kind of increment was
-     * applied.
-     * @param[in] v Previous version.
-     * @returns Which increment was performed.
-     */
-    Increment incrementType(const SemVer &v) const;
+    LogMessage &operator<<(bool value)
+    {
+        return *this << std::string_view(value ? "true" : "false");
+    }
 
-    /**
-     * @brief Parse a version string.
-     * @param[in] version SemVer-compatible string (e.g. "1.2.3").
-     * @returns `true` if parsed correctly, `false` otherwise.
-     */
-    bool parse(const std::string &version);
+    LogMessage &operator<<(double value);
 
-    /**
-     * @brief Convert to a string.
-     */
-    std::string str() const;
-
-    /** @brief String conversion operator. */
-    operator const std::string() const;
-
-    /** @brief Input operator. */
-    friend std::ostream &operator<<(std::ostream &out, const SemVer &v);
-
-    /** @brief Move operator. */
-    void operator=(const SemVer &v);
-    /** eq operator. */
-    bool operator==(const SemVer &v);
-    /** ne operator. */
-    bool operator!=(const SemVer &v);
-
-    /** gt operator. */
-    friend bool operator>(const SemVer &v1, const SemVer &v2);
-    /** gte operator. */
-    friend bool operator>=(const SemVer &v1, const SemVer &v2);
-    /** lt operator. */
-    friend bool operator<(const SemVer &v1, const SemVer &v2);
-    /** lte operator. */
-    friend bool operator<=(const SemVer &v1, const SemVer &v2);
+    template<typename T, typename = std::enable_if_t<std::is_integral_v<T>>>
+    LogMessage &operator<<(T value)
+    {
+        char buf[24];
+        const auto result = std::to_chars(buf, buf + sizeof(buf), value);
+        return *this << std::string_view(buf, result.ptr - buf);
+    }
 
 private:
-    int m_major;
-    int m_minor;
-    int m_patch;
-#endif
+    ILogger::Level m_level;
+    const LogCategory &m_category;
+    size_t m_length;
+    char m_buffer[MaxLength];
 };
 
+/** Library categories. */
+STANDARDRELEASE_EXPORT LogCategory &lcGit();
+STANDARDRELEASE_EXPORT LogCategory &lcCommits();
+STANDARDRELEASE_EXPORT LogCategory &lcChangelog();
+STANDARDRELEASE_EXPORT LogCategory &lcRelease();
+STANDARDRELEASE_EXPORT LogCategory &lcDaemon();
+
 }
+
+/**
+ * Messages below this level are removed at compile time (their arguments are never evaluated
+ * and no code is generated). Defaults to keeping everything.
+ */
+#ifndef STANDARDRELEASE_LOG_MIN_LEVEL
+#    define STANDARDRELEASE_LOG_MIN_LEVEL 0
+#endif
+
+// Usage: srLog(ILogger::Info, lcGit()) << "message";
+// The stream expression is only evaluated if the message will be written.
+#define srLog(level, category)                                                                     \
+    if constexpr (static_cast<int>(level) < STANDARDRELEASE_LOG_MIN_LEVEL) {                       \
+    } else                                                                                         \
+        for (bool srLogEnabled = (category).isEnabled(level); srLogEnabled; srLogEnabled = false)  \
+        ::StandardRelease::LogMessage(level, category)
+
+#define srDebug(category) srLog(::StandardRelease::ILogger::Debug, category)
+#define srInfo(category) srLog(::StandardRelease::ILogger::Info, category)
+#define srWarning(category) srLog(::StandardRelease::ILogger::Warning, category)
+#define srCritical(category) srLog(::StandardRelease::ILogger::Critical, category)
@@ -0,0 +1,212 @@
+#include "standard-release/plan/plan.h"
+#include "standard-release/stats/stats.h"
+#include "standard-release/util/json.h"
+#include "yaml-cpp/yaml.h"
+#include <fstream>
+#include <sstream>
+
+using namespace StandardRelease;
+
+// Bumped whenever a field changes meaning; older plans are rejected.
+static const int PlanFormat = 1;
+
+ReleasePlan::ReleasePlan()
+    : m_error()
+    , m_head()
+    , m_oldVersion()
+    , m_newVersion()
+    , m_types(CommitTypes::defaults())
+    , m_commits()
+    , m_changelog()
+    , m_files()
+{
+}
+
+Error ReleasePlan::error() const
+{
+    return m_error;
+}
+
+std::string ReleasePlan::head() const
+{
+    return m_head;
+}
+
+void ReleasePlan::setHead(const std::string &head)
+{
+    m_head = head;
+}
+
+SemVer ReleasePlan::oldVersion() const
+{
+    return m_oldVersion;
+}
+
+void ReleasePlan::setOldVersion(const SemVer &version)
+{
+    m_oldVersion = version;
+}
+
+SemVer ReleasePlan::newVersion() const
+{
+    return m_newVersion;
+}
+
+void ReleasePlan::setNewVersion(const SemVer &version)
+{
+    m_newVersion = version;
+}
+
+const CommitTypes &ReleasePlan::types() const
+{
+    return m_types;
+}
+
+void ReleasePlan::setTypes(const CommitTypes &types)
+{
+    m_types = types;
+}
+
+const CommitTable &ReleasePlan::commits() const
+{
+    return m_commits;
+}
+
+void ReleasePlan::setCommits(const CommitTable &commits)
+{
+    m_commits = commits;
+}
+
+std::string ReleasePlan::changelog() const
+{
+    return m_changelog;
+}
+
+void ReleasePlan::setChangelog(const std::string &block)
+{
+    m_changelog = block;
+}
+
+std::vector<std::string> ReleasePlan::files() const
+{
+    return m_files;
+}
+
+void ReleasePlan::setFiles(const std::vector<std::string> &files)
+{
+    m_files = files;
+}
+
+std::string ReleasePlan::json() const
+{
+    std::ostringstream out;
+
+    out << "{\n  \"format\": " << PlanFormat << ",\n  \"head\": ";
+    appendJsonString(out, m_head);
+    out << ",\n  \"oldVersion\": ";
+    appendJsonString(out, m_oldVersion.str());
+    out << ",\n  \"newVersion\": ";
+    appendJsonString(out, m_newVersion.str());
+    out << ",\n  \"commits\": [";
+
+    for (size_t row = 0; row < m_commits.size(); row++) {
+        out << (row == 0 ? "\n" : ",\n") << "    {\"hash\": ";
+        appendJsonString(out, m_commits.hash(row));
+        out << ", \"type\": ";
+        appendJsonString(out, m_types.type(m_commits.type(row)).name);
+        out << ", \"scope\": ";
+        appendJsonString(out, m_commits.scope(row));
+        out << ", \"subject\": ";
+        appendJsonString(out, m_commits.subject(row));
+        out << ", \"flags\": " << static_cast<int>(m_commits.flags(row)) << ", \"references\": [";
+        for (size_t i = 0; i < m_commits.referenceCount(row); i++) {
+            out << (i == 0 ? "" : ", ") << m_commits.reference(row, i);
+        }
+        out << "]}";
+    }
+
+    out << "\n  ],\n  \"changelog\": ";
+    appendJsonString(out, m_changelog);
+    out << ",\n  \"files\": [";
+    for (size_t i = 0; i < m_files.size(); i++) {
+        out << (i == 0 ? "" : ", ");
+        appendJsonString(out, m_files[i]);
+    }
+    out << "]\n}\n";
+
+    return out.str();
+}
+
+bool ReleasePlan::save(const std::filesystem::path &fileName) const
+{
+    std::ofstream out(fileName, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+
+    const std::string text = json();
+    out << text;
+    Stats::add(Stats::BytesWritten, text.size());
+
+    return static_cast<bool>(out);
+}
+
+bool ReleasePlan::load(const std::filesystem::path &fileName)
+{
+    const std::string file = fileName.string();
+    YAML::Node root;
+
+    // JSON is a subset of YAML, so the config parser reads plans too.
+    try {
+        root = YAML::LoadFile(file);
+    } catch (const YAML::Exception &e) {
+        m_error = Error(Error::PlanInvalid, file + ": " + e.what());
+        return false;
+    }
+
+    try {
+        if (!root.IsMap() || !root["format"] || root["format"].as<int>() != PlanFormat) {
+            m_error = Error(Error::PlanInvalid, file + ": unsupported format");
+            return false;
+        }
+
+        if (!m_oldVersion.parse(root["oldVersion"].as<std::string>())
+            || !m_newVersion.parse(root["newVersion"].as<std::string>())) {
+            m_error = Error(Error::PlanInvalid, file + ": invalid version");
+            return false;
+        }
+
+        m_head = root["head"].as<std::string>();
+        m_changelog = root["changelog"].as<std::string>();
+
+        m_commits.clear();
+        for (const auto &commit : root["commits"]) {
+            const auto type = commit["type"].as<std::string>();
+            const int id = m_types.find(type);
+            if (id < 0) {
+                m_error = Error(Error::PlanInvalid, file + ": unknown type " + type);
+                return false;
+            }
+
+            std::vector<uint32_t> references;
+            for (const auto &reference : commit["references"]) {
+                references.push_back(reference.as<uint32_t>());
+            }
+
+            m_commits.append(static_cast<CommitTable::Type>(id), commit["scope"].as<std::string>(),
+                             commit["subject"].as<std::string>(), commit["hash"].as<std::string>(),
+                             static_cast<uint8_t>(commit["flags"].as<int>()), references);
+        }
+
+        m_files.clear();
+        for (const auto &name : root["files"]) {
+            m_files.push_back(name.as<std::string>());
+        }
+    } catch (const YAML::Exception &e) {
+        m_error = Error(Error::PlanInvalid, file + ": " + e.what());
+        return false;
+    }
+
+    m_error = Error::Success;
+    return true;
+}
@@ -0,0 +1,87 @@
+/**
+ * @file "standard-release/plan/plan.h"
+ * @brief Release computed by one run and applied by a later one.
+ */
+#pragma once
+
+#include "standard-release/commits/table.h"
+#include "standard-release/commits/types.h"
+#include "standard-release/errors/errors.h"
+#include "standard-release/global/global.h"
+#include "standard-release/semver/semver.h"
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace StandardRelease {
+
+/**
+ * @brief Everything needed to make a release without reading the history again.
+ * @details Records the commit `HEAD` pointed to, the current and next version, the commits of
+ * the release, the rendered changelog entry and the files the release changes. Saved as JSON so
+ * a preview job can show it and an apply job can act on it (see Main::plan() and Main::apply()).
+ */
+class STANDARDRELEASE_EXPORT ReleasePlan
+{
+public:
+    ReleasePlan();
+
+    /** Most recent error of load(). */
+    Error error() const;
+
+    /** Full ID of the `HEAD` commit the plan was made for. */
+    std::string head() const;
+    void setHead(const std::string &head);
+
+    /** Version before the release. */
+    SemVer oldVersion() const;
+    void setOldVersion(const SemVer &version);
+
+    /** Version of the release. */
+    SemVer newVersion() const;
+    void setNewVersion(const SemVer &version);
+
+    /** Commit types used to name the types of commits(). */
+    const CommitTypes &types() const;
+    void setTypes(const CommitTypes &types);
+
+    /** Commits of the release. */
+    const CommitTable &commits() const;
+    void setCommits(const CommitTable &commits);
+
+    /** Rendered changelog entry (see IChangelog::renderRelease()). */
+    std::string changelog() const;
+    void setChangelog(const std::string &block);
+
+    /** Files the release changes, relative to the repository. */
+    std::vector<std::string> files() const;
+    void setFiles(const std::vector<std::string> &files);
+
+    /** The plan as JSON. */
+    std::string json() const;
+
+    /**
+     * @brief Write the plan as JSON.
+     * @returns `true` if successful.
+     */
+    bool save(const std::filesystem::path &fileName) const;
+
+    /**
+     * @brief Read a plan written by save().
+     * @details Commit types are looked up by name in types(), so set them first.
+     * @returns `true` if successful. Otherwise, `error()` will return an error description.
+     */
+    bool load(const std::filesystem::path &fileName);
+
+private:
+    Error m_error;
+    std::string m_head;
+    SemVer m_oldVersion;
+    SemVer m_newVersion;
+    CommitTypes m_types;
+    CommitTable m_commits;
+    std::string m_changelog;
+    std::vector<std::string> m_files;
+};
+
+}
@@ -15,6 +15,11 @@ struct StandardRelease::ISourcePrivate
 ISource::ISource()
     : d(new ISourcePrivate) {};
 
+ISource::~ISource()
+{
+    delete d;
+}
+
 std::string ISource::filename() const
 {
     return d->filename;
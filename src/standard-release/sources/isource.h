@@ -26,6 +26,10 @@ public:
      * @brief Create a new instance.
      */
     ISource();
+    virtual ~ISource();
+
+    ISource(const ISource &) = delete;
+    ISource &operator=(const ISource &) = delete;
 
     /** Current filename. */
     std::string filename() const;
@@ -1,5 +1,7 @@
 #include "json.h"
 #include "standard-release/semver/semver.h"
+#include "standard-release/stats/stats.h"
+#include "standard-release/trace/trace.h"
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -36,6 +38,7 @@ bool JsonFile::readFile(const std::string &fileName)
     contents << in.rdbuf();
     in.close();
     const std::string &content = contents.str();
+    Stats::add(Stats::BytesRead, content.size());
 
     bool ret = std::regex_search(content, match, std::regex(JSON_FIELD));
     if (match.empty() || !ret) {
@@ -60,6 +63,8 @@ bool JsonFile::readFile(const std::string &fileName)
 
 bool JsonFile::save()
 {
+    TraceSpan span("save", "source");
+
     std::string contents = d->contents;
     std::ofstream outfile(filename(), std::ofstream::out);
 
@@ -75,6 +80,7 @@ bool JsonFile::save()
     outfile << contents;
 
     outfile.close();
+    Stats::add(Stats::BytesWritten, contents.size());
 
     return true;
 }
@@ -1,5 +1,7 @@
 #include "text.h"
 #include "standard-release/semver/semver.h"
+#include "standard-release/stats/stats.h"
+#include "standard-release/trace/trace.h"
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -34,6 +36,7 @@ bool TextFile::readFile(const std::string &filename)
     contents << in.rdbuf();
     in.close();
     const std::string &content = contents.str();
+    Stats::add(Stats::BytesRead, content.size());
 
     std::regex_search(content, match, std::regex(VERSION));
     if (match.empty()) {
@@ -59,6 +62,8 @@ bool TextFile::readFile(const std::string &filename)
 
 bool TextFile::save()
 {
+    TraceSpan span("save", "source");
+
     std::string contents = d->contents;
     std::ofstream outfile(filename(), std::ofstream::out);
 
@@ -71,6 +76,7 @@ bool TextFile::save()
     outfile << contents;
 
     outfile.close();
+    Stats::add(Stats::BytesWritten, contents.size());
 
     return false;
 }
@@ -5,9 +5,13 @@
 #include "standard-release/errors/error.h"
 #include "standard-release/git/hooks.h"
 #include "standard-release/git/repository.h"
+#include "standard-release/log/ilog.h"
+#include "standard-release/plan/plan.h"
 #include "standard-release/semver/semver.h"
 #include "standard-release/sources/json.h"
 #include "standard-release/sources/text.h"
+#include "standard-release/tasks/graph.h"
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 
@@ -26,11 +30,13 @@ struct StandardRelease::MainPrivate
 {
     GitRepository repo;
     Error error;
-    IConventionalCommit *commits;
-    ISource *versionFile;
-    IConfig *config;
-    IChangelog *changelog;
-    Main::ReleaseType releaseType;
+    IConventionalCommit *commits = nullptr;
+    ISource *versionFile = nullptr;
+    IConfig *config = nullptr;
+    /** Was `config` read by this driver (rather than passed to setConfig())? */
+    bool ownsConfig = false;
+    IChangelog *changelog = nullptr;
+    Main::ReleaseType releaseType = Main::None;
     std::string dirName;
     std::string configFile;
 };
@@ -59,6 +65,21 @@ static ISource *scanForVersionFile(const std::string &dir)
     return nullptr;
 }
 
+// Path of a file relative to the repository, as recorded in release plans.
+static std::string repositoryPath(const std::string &fileName, const std::string &dirName)
+{
+    return std::filesystem::path(fileName).lexically_relative(dirName).generic_string();
+}
+
+static GitRepository::WalkMode walkModeFromString(const std::string &name)
+{
+    GitRepository::WalkMode mode;
+    if (!GitRepository::walkModeFromName(name, mode)) {
+        throw Exception("Unrecognized walk mode " + name);
+    }
+    return mode;
+}
+
 Main::Main()
     : d(new MainPrivate)
 {
@@ -72,6 +93,17 @@ Main::Main(const std::string &dirname)
     d->dirName = dirname;
 }
 
+Main::~Main()
+{
+    delete d->commits;
+    delete d->versionFile;
+    delete d->changelog;
+    if (d->ownsConfig) {
+        delete d->config;
+    }
+    delete d;
+}
+
 Error Main::error() const
 {
     return d->error;
@@ -121,6 +153,11 @@ std::string Main::readFile(const std::string &fileName)
     return contents.str();
 }
 
+void Main::setConfigFile(const std::string &fileName)
+{
+    d->configFile = fileName;
+}
+
 void Main::readConfigFile(const std::string &fileName)
 {
     std::error_code code;
@@ -152,9 +189,24 @@ void Main::readConfigFile(const std::string &fileName)
     const std::string &content = contents.str();
 
     d->config = new YamlConfig(filename);
+    d->ownsConfig = true;
     bool r = d->config->parse();
 }
 
+void Main::setConfig(IConfig *config)
+{
+    if (d->ownsConfig) {
+        delete d->config;
+    }
+    d->config = config;
+    d->ownsConfig = false;
+}
+
+SemVer Main::nextVersion() const
+{
+    return d->commits->version();
+}
+
 bool Main::init()
 {
     return false;
@@ -167,14 +219,16 @@ bool Main::lint()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-bool Main::release()
+void Main::openRepository()
 {
-    d->repo.open(directory());
-    if (d->repo.error()) {
+    const bool r = d->repo.open(directory());
+    if (!r) {
         throw Exception(d->repo.error());
-        return false;
     }
+}
 
+void Main::detectVersionFile()
+{
     auto releaseType = d->config->value("releaseType");
     ISource *versionFile = nullptr;
 
@@ -187,66 +241,231 @@ bool Main::release()
         throw Exception("Unrecognized project type " + releaseType);
     }
 
-    bool r = d->repo.open(directory());
-    if (!r) {
-        throw Exception("Not a git repository");
-        return false;
-    }
-
     versionFile->detect(directory());
     if (versionFile->error()) {
         throw Exception("Project version files not found");
     }
 
-    // std::cout << versionFile->version() << std::endl;
-
     d->versionFile = versionFile;
+}
 
-    d->repo.parse(d->versionFile->version());
-
-    auto repo_commits = d->repo.commits();
-
-    // std::cout << d->repo.dirName() << std::endl;
+void Main::readHistory()
+{
+    d->repo.setWalkMode(walkModeFromString(d->config->value("walk")));
+    d->repo.setPathFilter(d->config->value("path"));
+    d->repo.setPathIndex(d->config->value("pathIndex") == "true");
+    d->repo.setDetectDuplicates(d->config->value("detectDuplicates") == "true");
+    if (!d->repo.parse(d->versionFile->version())) {
+        throw Exception(d->repo.error());
+    }
+}
 
+void Main::parseCommits()
+{
     d->commits->setVersion(d->versionFile->version());
-    d->commits->parseCommits(repo_commits);
+    d->commits->setTypes(d->config->commitTypes());
+    d->commits->setExpandSquashes(d->config->value("expandSquashes") == "true");
+    d->commits->parseCommits(d->repo.commits());
     d->commits->bump();
+    srInfo(lcRelease()) << d->versionFile->version().str() << " -> "
+                        << d->commits->version().str();
+}
 
-    // std::cout << d->commits->version() << std::endl;
+bool Main::release()
+{
+    TaskGraph graph;
+    const auto changelogPath = std::filesystem::path(directory()) / "CHANGELOG.md";
 
-    const std::filesystem::path changelogPath = d->repo.dirName() / "CHANGELOG.md";
+    // Loading the config, opening the repository and reading the changelog are independent.
+    const auto config = graph.add("config", [this] {
+        if (d->config == nullptr) {
+            readConfigFile(d->configFile);
+        }
+    });
 
-    d->changelog = new Changelog();
-    d->changelog->setFilename(changelogPath);
-    d->changelog->read();
-    const auto oldVersion = d->versionFile->version();
-    const auto newVersion = d->commits->version();
-    d->changelog->generate(newVersion, oldVersion, d->commits->commits(), d->repo.url());
+    const auto open = graph.add("open", [this] { openRepository(); });
 
-    d->versionFile->setVersion(d->commits->version());
-    d->versionFile->save();
-    d->changelog->write();
+    const auto readChangelog = graph.add("changelog-read", [this, changelogPath] {
+        d->changelog = new Changelog();
+        d->changelog->setFilename(changelogPath);
+        d->changelog->read();
+    });
 
-    //
+    const auto detect = graph.add("detect", [this] { detectVersionFile(); }, { config });
 
-    r = d->repo.createRelease(d->commits->version());
+    const auto history = graph.add("history", [this] { readHistory(); }, { open, detect });
 
-    /*
-    auto commitMsg = std::string("chore(release): ") + d->commits->version().str();
-    auto versionStr = "v" + d->commits->version().str();
+    const auto commits = graph.add("commits", [this] { parseCommits(); }, { history });
 
-    r = d->repo.commit(commitMsg);
-    if (!r) {
-        throw Exception("Error commiting changes");
-    }
+    const auto generate = graph.add(
+            "changelog-generate",
+            [this] {
+                const auto oldVersion = d->versionFile->version();
+                const auto newVersion = d->commits->version();
+                d->changelog->setTypes(d->config->commitTypes());
+                d->changelog->setGroupByScope(d->config->value("groupByScope") == "true");
+                d->changelog->generate(newVersion, oldVersion, d->commits->table(),
+                                       d->repo.url());
+            },
+            { commits, readChangelog });
 
-    r = d->repo.createTag(versionStr, commitMsg);
-    if (!r) {
-        throw Exception("Error creating tag");
-    }
+    const auto saveVersion = graph.add(
+            "version-save",
+            [this] {
+                d->versionFile->setVersion(d->commits->version());
+                d->versionFile->save();
+            },
+            { generate });
+
+    const auto writeChangelog
+            = graph.add("changelog-write", [this] { d->changelog->write(); }, { generate });
 
-    d->repo.push();
-    */
+    graph.add(
+            "release", [this] { d->repo.createRelease(d->commits->version()); },
+            { saveVersion, writeChangelog });
+
+    graph.run();
 
     return false;
 }
+
+bool Main::plan(const std::string &planFile)
+{
+    TaskGraph graph;
+
+    const auto config = graph.add("config", [this] {
+        if (d->config == nullptr) {
+            readConfigFile(d->configFile);
+        }
+    });
+
+    const auto open = graph.add("open", [this] { openRepository(); });
+
+    const auto detect = graph.add("detect", [this] { detectVersionFile(); }, { config });
+
+    const auto history = graph.add("history", [this] { readHistory(); }, { open, detect });
+
+    const auto commits = graph.add("commits", [this] { parseCommits(); }, { history });
+
+    graph.add(
+            "plan-save",
+            [this, planFile] {
+                const auto oldVersion = d->versionFile->version();
+                const auto newVersion = d->commits->version();
+
+                Changelog changelog;
+                changelog.setTypes(d->config->commitTypes());
+                changelog.setGroupByScope(d->config->value("groupByScope") == "true");
+
+                const std::vector<std::string> files {
+                    "CHANGELOG.md",
+                    repositoryPath(d->versionFile->filename(), directory()),
+                };
+
+                ReleasePlan plan;
+                plan.setHead(d->repo.headId());
+                plan.setOldVersion(oldVersion);
+                plan.setNewVersion(newVersion);
+                plan.setTypes(d->config->commitTypes());
+                plan.setCommits(d->commits->table());
+                plan.setChangelog(changelog.renderRelease(newVersion, oldVersion,
+                                                          d->commits->table(), d->repo.url()));
+                plan.setFiles(files);
+
+                if (!plan.save(planFile)) {
+                    throw Exception("Unable to write release plan " + planFile);
+                }
+                srInfo(lcRelease()) << "planned " << oldVersion.str() << " -> "
+                                    << newVersion.str() << " at " << plan.head();
+            },
+            { commits });
+
+    graph.run();
+
+    return true;
+}
+
+bool Main::apply(const std::string &planFile)
+{
+    TaskGraph graph;
+    ReleasePlan plan;
+    const auto changelogPath = std::filesystem::path(directory()) / "CHANGELOG.md";
+
+    // Nothing here reads the history; the plan stands in for it.
+    const auto config = graph.add("config", [this] {
+        if (d->config == nullptr) {
+            readConfigFile(d->configFile);
+        }
+    });
+
+    const auto load = graph.add(
+            "plan-load",
+            [this, &plan, planFile] {
+                plan.setTypes(d->config->commitTypes());
+                if (!plan.load(planFile)) {
+                    throw Exception(plan.error());
+                }
+            },
+            { config });
+
+    const auto open = graph.add("open", [this] { openRepository(); });
+
+    const auto check = graph.add(
+            "plan-check",
+            [this, &plan] {
+                const auto head = d->repo.currentHeadId();
+                if (head != plan.head()) {
+                    throw Exception(Error(Error::HeadMoved,
+                                          "planned at " + plan.head() + ", now at " + head));
+                }
+            },
+            { load, open });
+
+    const auto detect = graph.add(
+            "detect",
+            [this, &plan] {
+                detectVersionFile();
+
+                const auto files = plan.files();
+                const auto versionPath = repositoryPath(d->versionFile->filename(), directory());
+                if (std::find(files.begin(), files.end(), versionPath) == files.end()) {
+                    throw Exception(Error(Error::PlanInvalid, versionPath + " is not in the plan"));
+                }
+                if (d->versionFile->version() != plan.oldVersion()) {
+                    throw Exception(Error(Error::PlanInvalid,
+                                          "planned from " + plan.oldVersion().str()
+                                                  + ", version file has "
+                                                  + d->versionFile->version().str()));
+                }
+            },
+            { load });
+
+    const auto readChangelog = graph.add("changelog-read", [this, changelogPath] {
+        d->changelog = new Changelog();
+        d->changelog->setFilename(changelogPath);
+        d->changelog->read();
+    });
+
+    const auto generate = graph.add(
+            "changelog-generate", [this, &plan] { d->changelog->insertRelease(plan.changelog()); },
+            { load, readChangelog, check });
+
+    const auto saveVersion = graph.add(
+            "version-save",
+            [this, &plan] {
+                d->versionFile->setVersion(plan.newVersion());
+                d->versionFile->save();
+            },
+            { detect, check });
+
+    const auto writeChangelog
+            = graph.add("changelog-write", [this] { d->changelog->write(); }, { generate });
+
+    graph.add(
+            "release", [this, &plan] { d->repo.createRelease(plan.newVersion()); },
+            { saveVersion, writeChangelog });
+
+    graph.run();
+
+    return true;
+}
@@ -7,11 +7,13 @@
 
 #include "standard-release/errors/errors.h"
 #include "standard-release/global/global.h"
+#include "standard-release/semver/semver.h"
 #include <string>
 
 namespace StandardRelease {
 
 class MainPrivate;
+class IConfig;
 
 /**
  * @brief Main driver for standard release.
@@ -29,6 +31,11 @@ public:
      */
     Main(const std::string &dirName);
 
+    ~Main();
+
+    Main(const Main &) = delete;
+    Main &operator=(const Main &) = delete;
+
     /**
      * Supported release types.
      */
@@ -59,12 +66,27 @@ public:
      */
     void setDirname(const std::string &dirName);
 
+    /**
+     * @brief Set the config file read by release().
+     * @param fileName Configuration file. If empty, the repository directory is searched.
+     */
+    void setConfigFile(const std::string &fileName);
+
     /**
      * @brief Open and read a config file.
      * @param fileName Configuration file. If empty, the repository directory is searched.
      */
     void readConfigFile(const std::string &fileName = "");
 
+    /**
+     * @brief Use a config that was already read (e.g. one shared by several repositories).
+     * @details The config is not copied and must outlive the driver.
+     */
+    void setConfig(IConfig *config);
+
+    /** Version of the release, once release() or plan() has parsed the commits. */
+    SemVer nextVersion() const;
+
     /**
      * @brief Initialize a new repository.
      * @details Installs the githooks and creates `.release.yml` if not found.
@@ -80,11 +102,35 @@ public:
 
     /**
      * @brief Create a new release.
+     * @details Runs as a graph of phases, so loading the config, opening the repository and
+     * reading the changelog overlap.
      * @returns true if successful, false otherwise.
      */
     bool release();
 
+    /**
+     * @brief Compute a release without making it.
+     * @details Writes the `HEAD` commit, current and next version, commits, changelog entry and
+     * the files to change to a JSON plan (see ReleasePlan) for apply().
+     * @param planFile Plan to write.
+     * @returns true if successful, false otherwise.
+     */
+    bool plan(const std::string &planFile);
+
+    /**
+     * @brief Make a release computed by plan() without reading the history again.
+     * @details Refuses to run if `HEAD` or the version file changed since the plan was made.
+     * @param planFile Plan to read.
+     * @returns true if successful, false otherwise.
+     */
+    bool apply(const std::string &planFile);
+
 private:
+    void openRepository();
+    void detectVersionFile();
+    void readHistory();
+    void parseCommits();
+
     std::string scanForConfigFile(const std::string &dirName);
 
     std::string readFile(const std::string &fileName);
@@ -0,0 +1,146 @@
+#include "allocprofiler.h"
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <sstream>
+
+using namespace StandardRelease;
+
+struct PhaseCounters
+{
+    std::atomic<uint64_t> allocations { 0 };
+    std::atomic<uint64_t> bytes { 0 };
+    std::atomic<uint64_t> frees { 0 };
+};
+
+// Plain arrays so the hooks never allocate (or run constructors) while counting.
+static PhaseCounters counters[AllocProfiler::MaxPhases];
+static thread_local int currentPhaseId = 0;
+
+// Names are only touched when registering a phase or reporting, never from the hooks.
+static std::mutex nameMutex;
+static std::vector<std::string> &phaseNames()
+{
+    static std::vector<std::string> names { "other" };
+    return names;
+}
+
+bool AllocProfiler::isCompiledIn()
+{
+#ifdef STANDARDRELEASE_ALLOC_PROFILER
+    return true;
+#else
+    return false;
+#endif
+}
+
+int AllocProfiler::phase(const std::string &name)
+{
+    // Registering may allocate; charge that to the caller's current phase.
+    std::lock_guard<std::mutex> lock(nameMutex);
+    auto &names = phaseNames();
+
+    for (size_t i = 0; i < names.size(); i++) {
+        if (names[i] == name) {
+            return static_cast<int>(i);
+        }
+    }
+    if (names.size() == MaxPhases) {
+        return 0;
+    }
+
+    names.push_back(name);
+    return static_cast<int>(names.size() - 1);
+}
+
+int AllocProfiler::currentPhase()
+{
+    return currentPhaseId;
+}
+
+void AllocProfiler::setCurrentPhase(int id)
+{
+    currentPhaseId = id >= 0 && id < MaxPhases ? id : 0;
+}
+
+void AllocProfiler::recordAllocation(size_t bytes)
+{
+    auto &phase = counters[currentPhaseId];
+    phase.allocations.fetch_add(1, std::memory_order_relaxed);
+    phase.bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void AllocProfiler::recordFree()
+{
+    counters[currentPhaseId].frees.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AllocProfiler::reset()
+{
+    for (auto &phase : counters) {
+        phase.allocations = 0;
+        phase.bytes = 0;
+        phase.frees = 0;
+    }
+}
+
+AllocProfiler::Phase AllocProfiler::counts(int id)
+{
+    Phase phase { "other", 0, 0, 0 };
+    if (id < 0 || id >= MaxPhases) {
+        return phase;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(nameMutex);
+        const auto &names = phaseNames();
+        if (static_cast<size_t>(id) < names.size()) {
+            phase.name = names[id];
+        }
+    }
+
+    phase.allocations = counters[id].allocations.load(std::memory_order_relaxed);
+    phase.bytes = counters[id].bytes.load(std::memory_order_relaxed);
+    phase.frees = counters[id].frees.load(std::memory_order_relaxed);
+    return phase;
+}
+
+std::vector<AllocProfiler::Phase> AllocProfiler::phases()
+{
+    size_t count;
+    {
+        std::lock_guard<std::mutex> lock(nameMutex);
+        count = phaseNames().size();
+    }
+
+    std::vector<Phase> result;
+    for (size_t id = 0; id < count; id++) {
+        const auto phase = counts(static_cast<int>(id));
+        if (phase.allocations > 0 || phase.frees > 0) {
+            result.push_back(phase);
+        }
+    }
+    return result;
+}
+
+std::string AllocProfiler::report(uint64_t commits)
+{
+    std::ostringstream out;
+    char line[160];
+
+    std::snprintf(line, sizeof(line), "%-24s %12s %14s %12s %12s\n", "Phase", "Allocations",
+                  "Bytes", "Frees", "Per commit");
+    out << line;
+
+    for (const auto &phase : phases()) {
+        const double perCommit = commits > 0 ? static_cast<double>(phase.allocations) / commits
+                                             : 0.0;
+        std::snprintf(line, sizeof(line), "%-24s %12llu %14llu %12llu %12.1f\n",
+                      phase.name.c_str(), static_cast<unsigned long long>(phase.allocations),
+                      static_cast<unsigned long long>(phase.bytes),
+                      static_cast<unsigned long long>(phase.frees), perCommit);
+        out << line;
+    }
+
+    return out.str();
+}
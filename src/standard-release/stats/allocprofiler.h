@@ -0,0 +1,100 @@
+/**
+ * @file standard-release/stats/allocprofiler.h
+ * @brief Allocation counts per release phase (`ENABLE_ALLOC_PROFILER` builds).
+ */
+#pragma once
+
+#include "standard-release/global/global.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace StandardRelease {
+
+/**
+ * @brief Counts allocations per phase.
+ * @details Each thread has a current phase (set with AllocPhase); the global `operator new` and
+ * `operator delete` hooks installed by `ENABLE_ALLOC_PROFILER` builds charge every call to it.
+ * Without the option nothing calls recordAllocation(), so every count stays zero.
+ */
+class STANDARDRELEASE_EXPORT AllocProfiler
+{
+public:
+    /** Phases beyond this are counted as `other`. */
+    static const int MaxPhases = 64;
+
+    /** Counts of one phase. */
+    struct Phase
+    {
+        std::string name;
+        uint64_t allocations;
+        uint64_t bytes;
+        uint64_t frees;
+    };
+
+    /** Was the profiler (and its hooks) compiled in? */
+    static bool isCompiledIn();
+
+    /** Id of a phase, registering it on first use. Id 0 is `other`. */
+    static int phase(const std::string &name);
+
+    /** Phase charged for allocations on the calling thread. */
+    static int currentPhase();
+
+    /** Set the phase charged for allocations on the calling thread. */
+    static void setCurrentPhase(int id);
+
+    /** Count an allocation against the current phase (called by the hooks). */
+    static void recordAllocation(size_t bytes);
+
+    /** Count a deallocation against the current phase (called by the hooks). */
+    static void recordFree();
+
+    /** Zero every count (phases stay registered). */
+    static void reset();
+
+    /** Counts of one phase. */
+    static Phase counts(int id);
+
+    /** Every phase with at least one allocation or free. */
+    static std::vector<Phase> phases();
+
+    /**
+     * @brief Human-readable table.
+     * @param commits Commits in the run; adds an allocations-per-commit column if non-zero.
+     */
+    static std::string report(uint64_t commits = 0);
+};
+
+/**
+ * @brief Charges allocations on the calling thread to a phase until destroyed.
+ * @details Compiles to nothing unless built with `ENABLE_ALLOC_PROFILER`.
+ */
+class AllocPhase
+{
+public:
+#ifdef STANDARDRELEASE_ALLOC_PROFILER
+    explicit AllocPhase(const std::string &name)
+        : m_previous(AllocProfiler::currentPhase())
+    {
+        AllocProfiler::setCurrentPhase(AllocProfiler::phase(name));
+    }
+
+    ~AllocPhase()
+    {
+        AllocProfiler::setCurrentPhase(m_previous);
+    }
+
+private:
+    int m_previous;
+#else
+    explicit AllocPhase(const std::string &) {}
+#endif
+
+public:
+    AllocPhase(const AllocPhase &) = delete;
+    AllocPhase &operator=(const AllocPhase &) = delete;
+};
+
+}
@@ -0,0 +1,202 @@
+#include "stats.h"
+#include "standard-release/util/json.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <sys/resource.h>
+
+using namespace StandardRelease;
+
+// Constant-initialized so the allocation hooks can use them before (and after) main().
+static std::atomic<uint64_t> counters[Stats::CounterCount];
+static std::atomic<bool> enabled { false };
+static std::atomic<int64_t> startTime { 0 };
+
+static std::mutex phaseMutex;
+static std::vector<Stats::Phase> phaseList;
+
+static int64_t steadyNs()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+static double clockMs(clockid_t clock)
+{
+    timespec ts;
+    if (clock_gettime(clock, &ts) != 0) {
+        return 0.0;
+    }
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+// Events per second of run time.
+static double rate(uint64_t count, double ms)
+{
+    return ms > 0.0 ? count * 1e3 / ms : 0.0;
+}
+
+void Stats::start()
+{
+    for (auto &counter : counters) {
+        counter = 0;
+    }
+    {
+        std::lock_guard<std::mutex> lock(phaseMutex);
+        phaseList.clear();
+    }
+    startTime = steadyNs();
+    enabled = true;
+}
+
+bool Stats::isEnabled()
+{
+    return enabled.load(std::memory_order_relaxed);
+}
+
+void Stats::add(Counter counter, uint64_t amount)
+{
+    counters[counter].fetch_add(amount, std::memory_order_relaxed);
+}
+
+uint64_t Stats::value(Counter counter)
+{
+    return counters[counter].load(std::memory_order_relaxed);
+}
+
+const char *Stats::name(Counter counter)
+{
+    switch (counter) {
+        case CommitsWalked:
+            return "commits_walked";
+        case CommitsDecoded:
+            return "commits_decoded";
+        case CommitsParsed:
+            return "commits_parsed";
+        case BytesRead:
+            return "bytes_read";
+        case BytesWritten:
+            return "bytes_written";
+        case Allocations:
+            return "allocations";
+        case AllocatedBytes:
+            return "allocated_bytes";
+        case CounterCount:
+        default:
+            return "unknown";
+    }
+}
+
+void Stats::recordPhase(const std::string &name, double wallMs, double cpuMs)
+{
+    if (!isEnabled()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(phaseMutex);
+    phaseList.push_back({ name, wallMs, cpuMs });
+}
+
+std::vector<Stats::Phase> Stats::phases()
+{
+    std::lock_guard<std::mutex> lock(phaseMutex);
+    return phaseList;
+}
+
+double Stats::elapsedMs()
+{
+    const int64_t start = startTime;
+    return start == 0 ? 0.0 : (steadyNs() - start) / 1e6;
+}
+
+double Stats::threadCpuMs()
+{
+    return clockMs(CLOCK_THREAD_CPUTIME_ID);
+}
+
+double Stats::processCpuMs()
+{
+    return clockMs(CLOCK_PROCESS_CPUTIME_ID);
+}
+
+uint64_t Stats::peakRss()
+{
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    // Linux reports kilobytes.
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+}
+
+std::string Stats::report()
+{
+    std::ostringstream out;
+    char line[160];
+    const double wall = elapsedMs();
+
+    std::snprintf(line, sizeof(line), "%-24s %12s %12s\n", "Phase", "Wall (ms)", "CPU (ms)");
+    out << line;
+    for (const auto &phase : phases()) {
+        std::snprintf(line, sizeof(line), "%-24s %12.2f %12.2f\n", phase.name.c_str(),
+                      phase.wallMs, phase.cpuMs);
+        out << line;
+    }
+    std::snprintf(line, sizeof(line), "%-24s %12.2f %12.2f\n\n", "total", wall, processCpuMs());
+    out << line;
+
+    for (int i = 0; i < CounterCount; i++) {
+        const auto counter = static_cast<Counter>(i);
+        const uint64_t count = value(counter);
+        std::snprintf(line, sizeof(line), "%-24s %12llu %12.0f/s\n", name(counter),
+                      static_cast<unsigned long long>(count), rate(count, wall));
+        out << line;
+    }
+    std::snprintf(line, sizeof(line), "%-24s %12llu\n", "peak_rss",
+                  static_cast<unsigned long long>(peakRss()));
+    out << line;
+
+    return out.str();
+}
+
+std::string Stats::json()
+{
+    std::ostringstream out;
+    const double wall = elapsedMs();
+
+    out << "{\n  \"wall_ms\": " << wall << ",\n  \"cpu_ms\": " << processCpuMs()
+        << ",\n  \"peak_rss\": " << peakRss() << ",\n  \"phases\": [";
+
+    const auto list = phases();
+    for (size_t i = 0; i < list.size(); i++) {
+        out << (i == 0 ? "\n" : ",\n") << "    {\"name\": ";
+        appendJsonString(out, list[i].name);
+        out << ", \"wall_ms\": " << list[i].wallMs << ", \"cpu_ms\": " << list[i].cpuMs << "}";
+    }
+    out << "\n  ],\n  \"counters\": {";
+
+    for (int i = 0; i < CounterCount; i++) {
+        const auto counter = static_cast<Counter>(i);
+        const uint64_t count = value(counter);
+        out << (i == 0 ? "\n" : ",\n") << "    \"" << name(counter) << "\": {\"total\": " << count
+            << ", \"per_second\": " << rate(count, wall) << "}";
+    }
+    out << "\n  }\n}\n";
+
+    return out.str();
+}
+
+bool Stats::save(const std::filesystem::path &file)
+{
+    std::ofstream out(file, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+
+    out << json();
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,98 @@
+/**
+ * @file standard-release/stats/stats.h
+ * @brief Run statistics.
+ */
+#pragma once
+
+#include "standard-release/global/global.h"
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace StandardRelease {
+
+/**
+ * @brief Process-wide counters and per-phase timings for `--stats`.
+ * @details Counters are relaxed atomics that are always updated; phase timings are recorded by
+ * TaskGraph. Allocation counters are only updated by executables that install the counting
+ * allocator (see `src/alloc.cpp`) and only while enabled.
+ */
+class STANDARDRELEASE_EXPORT Stats
+{
+public:
+    /** Throughput counters. */
+    enum Counter
+    {
+        /** Commits returned by the history walk. */
+        CommitsWalked,
+        /** Commits whose message was decoded. */
+        CommitsDecoded,
+        /** Commits parsed as conventional commits. */
+        CommitsParsed,
+        /** Bytes read from files (changelog, version files, indexes). */
+        BytesRead,
+        /** Bytes written to files and packs. */
+        BytesWritten,
+        /** Calls to `operator new`. */
+        Allocations,
+        /** Bytes requested from `operator new`. */
+        AllocatedBytes,
+        CounterCount,
+    };
+
+    /** Wall and CPU time of one phase. */
+    struct Phase
+    {
+        std::string name;
+        double wallMs;
+        double cpuMs;
+    };
+
+    /** Start collecting: resets everything and starts the run clock. */
+    static void start();
+
+    /** Is a run being collected? */
+    static bool isEnabled();
+
+    /** Add to a counter. */
+    static void add(Counter counter, uint64_t amount = 1);
+
+    /** Current value of a counter. */
+    static uint64_t value(Counter counter);
+
+    /** Name of a counter (e.g. `commits_walked`). */
+    static const char *name(Counter counter);
+
+    /** Record a finished phase. */
+    static void recordPhase(const std::string &name, double wallMs, double cpuMs);
+
+    /** Phases in the order they finished. */
+    static std::vector<Phase> phases();
+
+    /** Wall time since start(), in milliseconds. */
+    static double elapsedMs();
+
+    /** CPU time used by the calling thread, in milliseconds. */
+    static double threadCpuMs();
+
+    /** CPU time used by the process, in milliseconds. */
+    static double processCpuMs();
+
+    /** Peak resident set size, in bytes. */
+    static uint64_t peakRss();
+
+    /** Human-readable report. */
+    static std::string report();
+
+    /** Report as a JSON object. */
+    static std::string json();
+
+    /**
+     * @brief Write json() to a file.
+     * @returns `true` if the file was written.
+     */
+    static bool save(const std::filesystem::path &file);
+};
+
+}
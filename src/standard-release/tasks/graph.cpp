@@ -0,0 +1,114 @@
+#include "graph.h"
+#include "standard-release/errors/error.h"
+#include "standard-release/stats/allocprofiler.h"
+#include "standard-release/stats/stats.h"
+#include "standard-release/trace/trace.h"
+#include <atomic>
+#include <memory>
+
+using namespace StandardRelease;
+
+struct GraphNode
+{
+    std::string name;
+    TaskScheduler::Task task;
+    std::vector<TaskGraph::Node> dependents;
+    size_t dependencyCount = 0;
+    std::atomic<size_t> remaining { 0 };
+};
+
+struct StandardRelease::TaskGraphPrivate
+{
+    TaskScheduler &scheduler;
+    std::vector<std::unique_ptr<GraphNode>> nodes;
+
+    TaskGraphPrivate(TaskScheduler &scheduler)
+        : scheduler(scheduler)
+    {
+    }
+
+    void schedule(TaskGroup &group, TaskGraph::Node node)
+    {
+        group.run([this, &group, node] {
+            const int64_t begin = Tracer::now();
+            const double cpuBegin = Stats::isEnabled() ? Stats::threadCpuMs() : 0.0;
+
+            {
+                AllocPhase phase(nodes[node]->name);
+                nodes[node]->task();
+            }
+
+            const int64_t end = Tracer::now();
+            Tracer::global().record(nodes[node]->name, "task", begin, end);
+            if (Stats::isEnabled()) {
+                Stats::recordPhase(nodes[node]->name, (end - begin) / 1e3,
+                                   Stats::threadCpuMs() - cpuBegin);
+            }
+
+            for (const auto dependent : nodes[node]->dependents) {
+                if (--nodes[dependent]->remaining == 0) {
+                    schedule(group, dependent);
+                }
+            }
+        });
+    }
+};
+
+TaskGraph::TaskGraph(TaskScheduler &scheduler)
+    : d(new TaskGraphPrivate(scheduler))
+{
+}
+
+TaskGraph::~TaskGraph()
+{
+    delete d;
+}
+
+TaskGraph::Node TaskGraph::add(const std::string &name, TaskScheduler::Task task,
+                               const std::vector<Node> &dependencies)
+{
+    const Node node = d->nodes.size();
+    auto graphNode = std::make_unique<GraphNode>();
+
+    graphNode->name = name;
+    graphNode->task = std::move(task);
+    graphNode->dependencyCount = dependencies.size();
+
+    for (const auto dependency : dependencies) {
+        if (dependency >= node) {
+            throw Exception("Task '" + name + "' depends on a task that was added after it");
+        }
+        d->nodes[dependency]->dependents.push_back(node);
+    }
+
+    d->nodes.push_back(std::move(graphNode));
+
+    return node;
+}
+
+size_t TaskGraph::size() const
+{
+    return d->nodes.size();
+}
+
+std::string TaskGraph::name(Node node) const
+{
+    return d->nodes.at(node)->name;
+}
+
+void TaskGraph::run()
+{
+    TaskGroup group(d->scheduler);
+
+    for (auto &node : d->nodes) {
+        node->remaining = node->dependencyCount;
+    }
+
+    for (Node node = 0; node < d->nodes.size(); node++) {
+        if (d->nodes[node]->dependencyCount == 0) {
+            d->schedule(group, node);
+        }
+    }
+
+    group.wait();
+}
@@ -0,0 +1,62 @@
+/**
+ * @file "standard-release/tasks/graph.h"
+ * @brief Dependency graph of tasks.
+ */
+#pragma once
+
+#include "standard-release/global/global.h"
+#include "standard-release/tasks/scheduler.h"
+#include <string>
+#include <vector>
+
+namespace StandardRelease {
+
+class TaskGraphPrivate;
+
+/**
+ * @brief Directed acyclic graph of named tasks.
+ * @details Each task starts as soon as all of its dependencies have finished, so independent
+ * tasks overlap and the total time is bounded by the longest chain of dependencies.
+ * Dependencies must be added before their dependents, which rules out cycles.
+ */
+class STANDARDRELEASE_EXPORT TaskGraph
+{
+public:
+    /** Handle to a task in the graph. */
+    using Node = size_t;
+
+    /** Create an empty graph running on `scheduler`. */
+    explicit TaskGraph(TaskScheduler &scheduler = TaskScheduler::global());
+    ~TaskGraph();
+
+    TaskGraph(const TaskGraph &) = delete;
+    TaskGraph &operator=(const TaskGraph &) = delete;
+
+    /**
+     * @brief Add a task.
+     * @param[in] name Name used in diagnostics.
+     * @param[in] task Work to run.
+     * @param[in] dependencies Tasks that must finish first.
+     * @returns Handle for use as a dependency of later tasks.
+     */
+    Node add(const std::string &name, TaskScheduler::Task task,
+             const std::vector<Node> &dependencies = {});
+
+    /** Number of tasks. */
+    size_t size() const;
+
+    /** Name of a task. */
+    std::string name(Node node) const;
+
+    /**
+     * @brief Run every task and wait for them to finish.
+     * @details If a task throws, tasks that have not started yet are skipped.
+     * @throws The first exception thrown by a task.
+     */
+    void run();
+
+private:
+    TaskGraphPrivate *d;
+};
+
+}
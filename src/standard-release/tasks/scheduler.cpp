@@ -0,0 +1,335 @@
+#include "scheduler.h"
+#include "standard-release/trace/trace.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace StandardRelease;
+
+static std::atomic<size_t> defaultWorkers { 0 };
+
+// Pool and index of the worker running on this thread.
+static thread_local TaskSchedulerPrivate *currentPool = nullptr;
+static thread_local int currentIndex = -1;
+
+struct WorkerQueue
+{
+    std::mutex mutex;
+    std::deque<TaskScheduler::Task> tasks;
+};
+
+struct StandardRelease::TaskSchedulerPrivate
+{
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> threads;
+    WorkerQueue injected;
+
+    // Idle workers sleep on `wake` until `queued` is non-zero.
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::atomic<size_t> queued { 0 };
+    bool stopping = false;
+
+    void push(TaskScheduler::Task task)
+    {
+        WorkerQueue &queue = currentPool == this ? *queues[currentIndex] : injected;
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(std::move(task));
+        }
+        queued++;
+
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+        }
+        wake.notify_one();
+    }
+
+    static bool popBack(WorkerQueue &queue, TaskScheduler::Task &task)
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        return true;
+    }
+
+    static bool popFront(WorkerQueue &queue, TaskScheduler::Task &task)
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        return true;
+    }
+
+    // Own deque (newest first), then the shared queue, then steal (oldest first).
+    bool find(int index, TaskScheduler::Task &task)
+    {
+        if (queued.load(std::memory_order_acquire) == 0) {
+            return false;
+        }
+
+        bool found = index >= 0 && popBack(*queues[index], task);
+        if (!found) {
+            found = popFront(injected, task);
+        }
+
+        const size_t count = queues.size();
+        const size_t start = index >= 0 ? index + 1 : 0;
+        for (size_t i = 0; i < count && !found; i++) {
+            const size_t victim = (start + i) % count;
+            if (static_cast<int>(victim) != index) {
+                found = popFront(*queues[victim], task);
+            }
+        }
+
+        if (found) {
+            queued--;
+        }
+        return found;
+    }
+
+    void work(int index)
+    {
+        currentPool = this;
+        currentIndex = index;
+        Tracer::global().setThreadName("worker " + std::to_string(index));
+
+        TaskScheduler::Task task;
+        while (true) {
+            if (find(index, task)) {
+                task();
+                task = nullptr;
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            if (stopping && queued == 0) {
+                break;
+            }
+            wake.wait(lock, [this] { return stopping || queued > 0; });
+        }
+
+        currentPool = nullptr;
+        currentIndex = -1;
+    }
+};
+
+TaskScheduler::TaskScheduler(size_t workers)
+    : d(new TaskSchedulerPrivate)
+{
+    if (workers == 0) {
+        workers = defaultWorkerCount();
+    }
+
+    for (size_t i = 0; i < workers; i++) {
+        d->queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (size_t i = 0; i < workers; i++) {
+        d->threads.emplace_back([this, i] { d->work(static_cast<int>(i)); });
+    }
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(d->sleepMutex);
+        d->stopping = true;
+    }
+    d->wake.notify_all();
+
+    for (auto &thread : d->threads) {
+        thread.join();
+    }
+
+    delete d;
+}
+
+TaskScheduler &TaskScheduler::global()
+{
+    static TaskScheduler scheduler;
+    return scheduler;
+}
+
+size_t TaskScheduler::defaultWorkerCount()
+{
+    const size_t workers = defaultWorkers;
+    if (workers != 0) {
+        return workers;
+    }
+
+    const size_t hardware = std::thread::hardware_concurrency();
+    return hardware == 0 ? 1 : hardware;
+}
+
+void TaskScheduler::setDefaultWorkerCount(size_t workers)
+{
+    defaultWorkers = workers;
+}
+
+size_t TaskScheduler::workerCount() const
+{
+    return d->threads.size();
+}
+
+void TaskScheduler::submit(Task task)
+{
+    d->push(std::move(task));
+}
+
+bool TaskScheduler::runPending()
+{
+    Task task;
+    const int index = currentPool == d ? currentIndex : -1;
+
+    if (!d->find(index, task)) {
+        return false;
+    }
+
+    task();
+    return true;
+}
+
+int TaskScheduler::currentWorker() const
+{
+    return currentPool == d ? currentIndex : -1;
+}
+
+CancellationToken::CancellationToken()
+    : m_cancelled(std::make_shared<std::atomic<bool>>(false))
+{
+}
+
+void CancellationToken::cancel()
+{
+    m_cancelled->store(true);
+}
+
+bool CancellationToken::isCancelled() const
+{
+    return m_cancelled->load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief State shared by a group and its queued tasks (which may outlive a cancelled group).
+ */
+struct StandardRelease::TaskGroupState
+{
+    std::atomic<size_t> pending { 0 };
+    std::mutex mutex;
+    std::condition_variable done;
+    std::exception_ptr error;
+    CancellationToken token;
+};
+
+TaskGroup::TaskGroup(TaskScheduler &scheduler)
+    : m_scheduler(scheduler)
+    , m_state(std::make_shared<TaskGroupState>())
+{
+}
+
+TaskGroup::~TaskGroup()
+{
+    try {
+        wait();
+    } catch (...) {
+        // Only wait() reports errors.
+    }
+}
+
+void TaskGroup::run(TaskScheduler::Task task)
+{
+    auto state = m_state;
+    state->pending++;
+
+    m_scheduler.submit([state, task = std::move(task)] {
+        if (!state->token.isCancelled()) {
+            try {
+                task();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (!state->error) {
+                    state->error = std::current_exception();
+                }
+                state->token.cancel();
+            }
+        }
+
+        if (--state->pending == 0) {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->done.notify_all();
+        }
+    });
+}
+
+void TaskGroup::wait()
+{
+    auto state = m_state;
+
+    while (state->pending > 0) {
+        // Help out instead of blocking a worker that the group's own tasks may need.
+        if (m_scheduler.runPending()) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->done.wait_for(lock, std::chrono::milliseconds(1),
+                             [&state] { return state->pending == 0; });
+    }
+
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        std::swap(error, state->error);
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void TaskGroup::cancel()
+{
+    m_state->token.cancel();
+}
+
+bool TaskGroup::isCancelled() const
+{
+    return m_state->token.isCancelled();
+}
+
+CancellationToken TaskGroup::token() const
+{
+    return m_state->token;
+}
+
+void StandardRelease::parallelFor(TaskScheduler &scheduler, size_t count, size_t grain,
+                                  const std::function<void(size_t, size_t)> &fn)
+{
+    if (grain == 0) {
+        grain = 1;
+    }
+
+    if (count <= grain) {
+        if (count > 0) {
+            fn(0, count);
+        }
+        return;
+    }
+
+    TaskGroup group(scheduler);
+    for (size_t begin = 0; begin < count; begin += grain) {
+        const size_t end = std::min(count, begin + grain);
+        group.run([&fn, begin, end] { fn(begin, end); });
+    }
+    group.wait();
+}
@@ -0,0 +1,144 @@
+/**
+ * @file "standard-release/tasks/scheduler.h"
+ * @brief Work-stealing task scheduler.
+ */
+#pragma once
+
+#include "standard-release/global/global.h"
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+namespace StandardRelease {
+
+class TaskSchedulerPrivate;
+struct TaskGroupState;
+
+/**
+ * @brief Work-stealing thread pool.
+ * @details Every worker owns a deque of tasks. Tasks submitted from a worker are pushed onto
+ * its own deque and run newest-first; idle workers steal the oldest task from another worker.
+ * Tasks submitted from other threads go through a shared queue.
+ */
+class STANDARDRELEASE_EXPORT TaskScheduler
+{
+public:
+    /** A unit of work. */
+    using Task = std::function<void()>;
+
+    /**
+     * @brief Start a new pool.
+     * @param[in] workers Number of worker threads. `0` uses defaultWorkerCount().
+     */
+    explicit TaskScheduler(size_t workers = 0);
+
+    /** Runs every task that is still queued, then stops the workers. */
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler &) = delete;
+    TaskScheduler &operator=(const TaskScheduler &) = delete;
+
+    /** Scheduler shared by the whole library, created on first use. */
+    static TaskScheduler &global();
+
+    /** Number of workers used by default (the number of hardware threads unless changed). */
+    static size_t defaultWorkerCount();
+
+    /**
+     * @brief Change the default number of workers.
+     * @note Only affects schedulers created afterwards (including global(), if not created yet).
+     */
+    static void setDefaultWorkerCount(size_t workers);
+
+    /** Number of worker threads. */
+    size_t workerCount() const;
+
+    /** Queue a task that is not part of any group. */
+    void submit(Task task);
+
+    /**
+     * @brief Run one queued task on the calling thread.
+     * @returns `false` if no task was available.
+     */
+    bool runPending();
+
+    /** Index of the calling thread in this pool, or `-1` if it is not one of its workers. */
+    int currentWorker() const;
+
+private:
+    TaskSchedulerPrivate *d;
+};
+
+/**
+ * @brief Cooperative cancellation flag shared by a group and its tasks.
+ */
+class STANDARDRELEASE_EXPORT CancellationToken
+{
+public:
+    CancellationToken();
+
+    /** Request cancellation. */
+    void cancel();
+
+    /** Has cancellation been requested? Long-running tasks should check this periodically. */
+    bool isCancelled() const;
+
+private:
+    std::shared_ptr<std::atomic<bool>> m_cancelled;
+};
+
+/**
+ * @brief Set of tasks that are waited on and cancelled together.
+ * @details Tasks that have not started when the group is cancelled are skipped. If a task
+ * throws, the group is cancelled and the exception is rethrown by wait().
+ */
+class STANDARDRELEASE_EXPORT TaskGroup
+{
+public:
+    /** Create a group running on `scheduler`. */
+    explicit TaskGroup(TaskScheduler &scheduler = TaskScheduler::global());
+
+    /** Waits for every task (exceptions are discarded). */
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup &) = delete;
+    TaskGroup &operator=(const TaskGroup &) = delete;
+
+    /** Queue a task in this group. */
+    void run(TaskScheduler::Task task);
+
+    /**
+     * @brief Wait until every task in the group has finished.
+     * @details The calling thread runs queued tasks while it waits, so groups can be nested
+     * inside tasks without exhausting the pool.
+     * @throws The first exception thrown by a task.
+     */
+    void wait();
+
+    /** Skip every task that has not started yet. */
+    void cancel();
+
+    /** Has the group been cancelled? */
+    bool isCancelled() const;
+
+    /** Token that tasks can poll to stop early. */
+    CancellationToken token() const;
+
+private:
+    TaskScheduler &m_scheduler;
+    std::shared_ptr<TaskGroupState> m_state;
+};
+
+/**
+ * @brief Split `[0, count)` into chunks of at most `grain` items and run them in parallel.
+ * @param[in] scheduler Scheduler to run on.
+ * @param[in] count Number of items.
+ * @param[in] grain Maximum items per task (at least 1).
+ * @param[in] fn Called as `fn(begin, end)` for every chunk.
+ * @throws The first exception thrown by `fn`.
+ */
+STANDARDRELEASE_EXPORT void parallelFor(TaskScheduler &scheduler, size_t count, size_t grain,
+                                        const std::function<void(size_t, size_t)> &fn);
+
+}
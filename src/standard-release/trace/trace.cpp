@@ -0,0 +1,220 @@
+#include "trace.h"
+#include "standard-release/util/json.h"
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <unistd.h>
+#include <vector>
+
+using namespace StandardRelease;
+
+struct TraceEvent
+{
+    std::string name;
+    const char *category;
+    int64_t begin;
+    int64_t duration;
+    std::string detail;
+};
+
+/**
+ * @brief Spans recorded by one thread.
+ * @details Only its own thread appends; the mutex is uncontended except while serializing.
+ */
+struct ThreadBuffer
+{
+    std::mutex mutex;
+    uint32_t tid;
+    std::string name;
+    std::vector<TraceEvent> events;
+};
+
+// Distinguishes tracers so a thread's cached buffer is never used with the wrong one.
+static std::atomic<uint64_t> nextTracerId { 1 };
+
+struct StandardRelease::TracerPrivate
+{
+    uint64_t id = nextTracerId++;
+    std::atomic<bool> enabled { false };
+
+    mutable std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+
+    ThreadBuffer &buffer()
+    {
+        struct Cache
+        {
+            uint64_t owner = 0;
+            ThreadBuffer *buffer = nullptr;
+        };
+        static thread_local Cache cache;
+
+        if (cache.owner != id) {
+            auto created = std::make_shared<ThreadBuffer>();
+            std::lock_guard<std::mutex> lock(mutex);
+            created->tid = static_cast<uint32_t>(buffers.size() + 1);
+            buffers.push_back(created);
+            cache.owner = id;
+            cache.buffer = created.get();
+        }
+        return *cache.buffer;
+    }
+};
+
+Tracer::Tracer()
+    : d(new TracerPrivate)
+{
+}
+
+Tracer::~Tracer()
+{
+    delete d;
+}
+
+Tracer &Tracer::global()
+{
+    static Tracer tracer;
+    return tracer;
+}
+
+int64_t Tracer::now()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void Tracer::start()
+{
+    d->enabled = true;
+}
+
+void Tracer::stop()
+{
+    d->enabled = false;
+}
+
+bool Tracer::isEnabled() const
+{
+    return d->enabled.load(std::memory_order_relaxed);
+}
+
+void Tracer::record(const std::string &name, const char *category, int64_t begin, int64_t end,
+                    const std::string &detail)
+{
+    if (!isEnabled()) {
+        return;
+    }
+
+    ThreadBuffer &buffer = d->buffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.events.push_back({ name, category, begin, end - begin, detail });
+}
+
+void Tracer::setThreadName(const std::string &name)
+{
+    ThreadBuffer &buffer = d->buffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.name = name;
+}
+
+size_t Tracer::size() const
+{
+    size_t count = 0;
+    std::lock_guard<std::mutex> lock(d->mutex);
+    for (const auto &buffer : d->buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        count += buffer->events.size();
+    }
+    return count;
+}
+
+void Tracer::clear()
+{
+    std::lock_guard<std::mutex> lock(d->mutex);
+    for (const auto &buffer : d->buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        buffer->events.clear();
+    }
+}
+
+std::string Tracer::json() const
+{
+    std::ostringstream out;
+    const long pid = static_cast<long>(getpid());
+    bool first = true;
+
+    const auto separator = [&out, &first] {
+        out << (first ? "\n" : ",\n");
+        first = false;
+    };
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    std::lock_guard<std::mutex> lock(d->mutex);
+    for (const auto &buffer : d->buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+
+        if (!buffer->name.empty()) {
+            separator();
+            out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid
+                << ",\"tid\":" << buffer->tid << ",\"args\":{\"name\":";
+            appendJsonString(out, buffer->name);
+            out << "}}";
+        }
+
+        for (const auto &event : buffer->events) {
+            separator();
+            out << "{\"name\":";
+            appendJsonString(out, event.name);
+            out << ",\"cat\":";
+            appendJsonString(out, event.category);
+            out << ",\"ph\":\"X\",\"ts\":" << event.begin << ",\"dur\":" << event.duration
+                << ",\"pid\":" << pid << ",\"tid\":" << buffer->tid;
+            if (!event.detail.empty()) {
+                out << ",\"args\":{\"detail\":";
+                appendJsonString(out, event.detail);
+                out << "}";
+            }
+            out << "}";
+        }
+    }
+
+    out << "\n]}\n";
+    return out.str();
+}
+
+bool Tracer::save(const std::filesystem::path &file) const
+{
+    std::ofstream out(file, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+
+    out << json();
+    return static_cast<bool>(out);
+}
+
+TraceSpan::TraceSpan(const char *name, const char *category)
+    : m_name(name)
+    , m_category(category)
+    , m_begin(Tracer::global().isEnabled() ? Tracer::now() : 0)
+{
+}
+
+TraceSpan::~TraceSpan()
+{
+    Tracer &tracer = Tracer::global();
+    if (m_begin != 0 && tracer.isEnabled()) {
+        tracer.record(m_name, m_category, m_begin, Tracer::now(), m_detail);
+    }
+}
+
+void TraceSpan::setDetail(const std::string &detail)
+{
+    if (m_begin != 0) {
+        m_detail = detail;
+    }
+}
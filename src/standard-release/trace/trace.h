@@ -0,0 +1,104 @@
+/**
+ * @file standard-release/trace/trace.h
+ * @brief Chrome trace-event recording.
+ */
+#pragma once
+
+#include "standard-release/global/global.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+namespace StandardRelease {
+
+class TracerPrivate;
+
+/**
+ * @brief Records timed spans for the Chrome/Perfetto trace viewer.
+ * @details Each thread appends to its own buffer, so recording does not contend between
+ * threads. While disabled (the default), spans cost a single atomic load.
+ */
+class STANDARDRELEASE_EXPORT Tracer
+{
+public:
+    Tracer();
+    ~Tracer();
+
+    Tracer(const Tracer &) = delete;
+    Tracer &operator=(const Tracer &) = delete;
+
+    /** Process-wide tracer used by TraceSpan. */
+    static Tracer &global();
+
+    /** Microseconds on the tracer's clock. */
+    static int64_t now();
+
+    /** Start recording (keeps spans recorded earlier). */
+    void start();
+
+    /** Stop recording. */
+    void stop();
+
+    /** Are spans being recorded? */
+    bool isEnabled() const;
+
+    /**
+     * @brief Record a complete span.
+     * @param name Span name.
+     * @param category Span category; must outlive the tracer (normally a string literal).
+     * @param begin Start time from now().
+     * @param end End time from now().
+     * @param detail Optional text shown in the viewer's argument panel.
+     */
+    void record(const std::string &name, const char *category, int64_t begin, int64_t end,
+                const std::string &detail = std::string());
+
+    /** Name the calling thread in the trace (e.g. `worker 2`). */
+    void setThreadName(const std::string &name);
+
+    /** Number of spans recorded so far. */
+    size_t size() const;
+
+    /** Discard all recorded spans. */
+    void clear();
+
+    /** Serialize as trace-event JSON (`{"traceEvents": [...]}`). */
+    std::string json() const;
+
+    /**
+     * @brief Write the trace-event JSON to a file.
+     * @returns `true` if the file was written.
+     */
+    bool save(const std::filesystem::path &file) const;
+
+private:
+    TracerPrivate *d;
+};
+
+/**
+ * @brief Records a span in the global tracer from construction to destruction.
+ * @code
+ * TraceSpan span("changelog-write", "changelog");
+ * @endcode
+ */
+class STANDARDRELEASE_EXPORT TraceSpan
+{
+public:
+    TraceSpan(const char *name, const char *category);
+    ~TraceSpan();
+
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+    /** Attach text to the span (ignored while tracing is disabled). */
+    void setDetail(const std::string &detail);
+
+private:
+    const char *m_name;
+    const char *m_category;
+    int64_t m_begin;
+    std::string m_detail;
+};
+
+}
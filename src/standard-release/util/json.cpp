@@ -0,0 +1,35 @@
+#include "json.h"
+#include <cstdio>
+
+using namespace StandardRelease;
+
+void StandardRelease::appendJsonString(std::ostream &out, std::string_view str)
+{
+    out << '"';
+    for (const char c : str) {
+        switch (c) {
+            case '"':
+                out << "\\\"";
+                break;
+            case '\\':
+                out << "\\\\";
+                break;
+            case '\n':
+                out << "\\n";
+                break;
+            case '\t':
+                out << "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out << buf;
+                } else {
+                    out << c;
+                }
+                break;
+        }
+    }
+    out << '"';
+}
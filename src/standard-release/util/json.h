@@ -0,0 +1,15 @@
+/**
+ * @file "standard-release/util/json.h"
+ * @brief Helpers for writing JSON by hand.
+ */
+#pragma once
+
+#include <ostream>
+#include <string_view>
+
+namespace StandardRelease {
+
+/** Write `str` as a quoted JSON string. */
+void appendJsonString(std::ostream &out, std::string_view str);
+
+}
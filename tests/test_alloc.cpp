@@ -0,0 +1,113 @@
+#include "boost/ut.hpp"
+#include "standard-release/commits/conventional.h"
+#include "standard-release/git/repository.h"
+#include "standard-release/semver/semver.h"
+#include "standard-release/stats/allocprofiler.h"
+#include <string>
+#include <thread>
+
+using namespace boost::ut;
+using namespace boost::ut::spec;
+using namespace StandardRelease;
+
+/*
+ * Allocation budgets. Measured values plus some headroom: lower them when an optimization lands,
+ * never raise them to make a regression pass.
+ */
+static const uint64_t SemVerParseBudget = 10000;
+static const uint64_t ConventionalCommitBudget = 1700;
+
+static uint64_t allocations(const std::string &name)
+{
+    return AllocProfiler::counts(AllocProfiler::phase(name)).allocations;
+}
+
+int main()
+{
+    "AllocProfiler"_test = [] {
+        it("should charge allocations to the current phase") = [] {
+            AllocProfiler::phase("ten");
+            AllocProfiler::reset();
+            {
+                AllocPhase phase("ten");
+                for (int i = 0; i < 10; i++) {
+                    // volatile keeps the compiler from eliding the pair.
+                    int *volatile ptr = new int(i);
+                    delete ptr;
+                }
+            }
+
+            const auto counts = AllocProfiler::counts(AllocProfiler::phase("ten"));
+            expect(that % counts.allocations == static_cast<uint64_t>(10));
+            expect(that % counts.frees == static_cast<uint64_t>(10));
+            expect(that % counts.bytes == static_cast<uint64_t>(10 * sizeof(int)));
+        };
+
+        it("should restore the previous phase") = [] {
+            const int outerId = AllocProfiler::phase("outer");
+            AllocProfiler::phase("inner");
+            {
+                AllocPhase outer("outer");
+                {
+                    AllocPhase inner("inner");
+                }
+                expect(that % AllocProfiler::currentPhase() == outerId);
+            }
+            expect(that % AllocProfiler::currentPhase() == 0);
+        };
+
+        it("should not charge other threads to this phase") = [] {
+            AllocProfiler::phase("main-thread");
+            AllocProfiler::reset();
+            {
+                AllocPhase phase("main-thread");
+                std::thread worker([] {
+                    for (int i = 0; i < 100; i++) {
+                        int *volatile ptr = new int(i);
+                        delete ptr;
+                    }
+                });
+                worker.join();
+            }
+            expect(that % allocations("main-thread") < static_cast<uint64_t>(100));
+        };
+    };
+
+    "Allocation budgets"_test = [] {
+        it("should parse a version within budget") = [] {
+            SemVer version;
+            version.parse("1.0.0");
+            AllocProfiler::reset();
+            {
+                AllocPhase phase("semver-parse");
+                for (int i = 0; i < 10; i++) {
+                    version.parse("v10.20.30-rc.1");
+                }
+            }
+            const auto perCall = allocations("semver-parse") / 10;
+            expect(that % perCall <= SemVerParseBudget) << "allocations per SemVer::parse";
+        };
+
+        it("should parse conventional commits within budget") = [] {
+            GitRepository::Commits commits;
+            for (int i = 0; i < 100; i++) {
+                const auto hash = std::to_string(1000000 + i);
+                commits.push_back(GitRepository::Commit(i % 2 ? "feat(core): add a walk mode"
+                                                               : "fix: handle trailing commas",
+                                                        i % 5 ? "" : "BREAKING CHANGE: gone",
+                                                        hash.c_str()));
+            }
+
+            AllocProfiler::reset();
+            {
+                AllocPhase phase("conventional-parse");
+                ConventionalCommits conventional;
+                conventional.setVersion(SemVer(1, 0, 0));
+                conventional.parseCommits(commits);
+                conventional.bump();
+            }
+            const auto perCommit = allocations("conventional-parse") / commits.size();
+            expect(that % perCommit <= ConventionalCommitBudget) << "allocations per commit";
+        };
+    };
+}
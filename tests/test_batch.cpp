@@ -0,0 +1,149 @@
+#include "boost/ut.hpp"
+#include "git2.h"
+#include "standard-release/batch/batch.h"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace boost::ut;
+using namespace boost::ut::spec;
+using namespace StandardRelease;
+
+static void writeFile(const std::filesystem::path &path, const std::string &contents)
+{
+    std::ofstream out(path);
+    out << contents;
+}
+
+// Commit every file in the working directory.
+static void commitAll(const std::filesystem::path &dir, const std::string &msg)
+{
+    git_repository *repo = nullptr;
+    git_index *index = nullptr;
+    git_tree *tree = nullptr;
+    git_signature *sig = nullptr;
+    git_object *parent = nullptr;
+    git_oid treeOid;
+    git_oid commitOid;
+
+    git_repository_open(&repo, dir.string().c_str());
+    git_repository_index(&index, repo);
+    git_index_add_all(index, nullptr, GIT_INDEX_ADD_DEFAULT, nullptr, nullptr);
+    git_index_write_tree(&treeOid, index);
+    git_index_write(index);
+    git_tree_lookup(&tree, repo, &treeOid);
+    git_signature_default(&sig, repo);
+
+    if (git_revparse_single(&parent, repo, "HEAD") == GIT_OK) {
+        const git_commit *parents[] = { reinterpret_cast<git_commit *>(parent) };
+        git_commit_create(&commitOid, repo, "HEAD", sig, sig, nullptr, msg.c_str(), tree, 1,
+                          parents);
+    } else {
+        git_commit_create(&commitOid, repo, "HEAD", sig, sig, nullptr, msg.c_str(), tree, 0,
+                          nullptr);
+    }
+
+    git_object_free(parent);
+    git_signature_free(sig);
+    git_tree_free(tree);
+    git_index_free(index);
+    git_repository_free(repo);
+}
+
+// Repository at version 1.0.0 with one commit of `type` since.
+static void createProject(const std::filesystem::path &dir, const std::string &type)
+{
+    git_repository *repo = nullptr;
+    git_config *config = nullptr;
+
+    std::filesystem::create_directories(dir);
+    git_repository_init(&repo, dir.string().c_str(), 0);
+    git_repository_config(&config, repo);
+    git_config_set_string(config, "user.name", "Standard Release");
+    git_config_set_string(config, "user.email", "release@example.com");
+    git_config_free(config);
+    git_repository_free(repo);
+
+    writeFile(dir / "release.yml", "releaseType: text\n");
+    writeFile(dir / "VERSION.txt", "1.0.0\n");
+    commitAll(dir, "chore: initial commit");
+
+    writeFile(dir / "src.txt", type + "\n");
+    commitAll(dir, type + ": change src");
+}
+
+int main()
+{
+    git_libgit2_init();
+
+    "BatchRelease"_test = [] {
+        const auto root = std::filesystem::temp_directory_path() / "standard-release-batch";
+        std::filesystem::remove_all(root);
+
+        it("should read a list of repositories") = [root] {
+            std::filesystem::create_directories(root);
+            writeFile(root / "repos.txt", "# nightly\n  one  \n\ntwo\r\n");
+
+            std::vector<std::string> dirNames;
+            expect(BatchRelease::readList(root / "repos.txt", dirNames));
+            expect(dirNames == std::vector<std::string> { "one", "two" });
+            expect(!BatchRelease::readList(root / "missing.txt", dirNames));
+        };
+
+        it("should release every repository and report each result") = [root] {
+            createProject(root / "app", "feat");
+            createProject(root / "lib", "fix");
+
+            BatchRelease releases;
+            releases.addRepository((root / "app").string());
+            releases.addRepository((root / "missing").string());
+            releases.addRepository((root / "lib").string());
+            releases.setJobs(2);
+            expect(that % releases.jobs() == static_cast<size_t>(2));
+
+            const auto results = releases.run();
+            expect(that % results.size() == static_cast<size_t>(3));
+            expect(that % results[0].exitCode == EXIT_SUCCESS) << results[0].message;
+            expect(that % results[0].version == std::string("1.1.0"));
+            expect(that % results[1].exitCode == EXIT_FAILURE);
+            expect(!results[1].message.empty());
+            expect(that % results[2].exitCode == EXIT_SUCCESS) << results[2].message;
+            expect(that % results[2].version == std::string("1.0.1"));
+
+            const auto report = BatchRelease::report(results);
+            expect(report.find("\"succeeded\": 2") != std::string::npos) << report;
+            expect(report.find("\"failed\": 1") != std::string::npos) << report;
+        };
+
+        it("should fail a repository whose history cannot be read") = [root] {
+            createProject(root / "good", "feat");
+            createProject(root / "broken", "feat");
+
+            // A version tag that is not a commit cannot start the range of new commits.
+            git_repository *repo = nullptr;
+            git_reference *ref = nullptr;
+            git_oid blob;
+            git_repository_open(&repo, (root / "broken").string().c_str());
+            git_blob_create_from_buffer(&blob, repo, "1.0.0", 5);
+            git_reference_create(&ref, repo, "refs/tags/v1.0.0", &blob, 0, nullptr);
+            git_reference_free(ref);
+            git_repository_free(repo);
+
+            BatchRelease releases;
+            releases.addRepository((root / "broken").string());
+            releases.addRepository((root / "good").string());
+
+            const auto results = releases.run();
+            expect(that % results.size() == static_cast<size_t>(2));
+            expect(that % results[0].exitCode == EXIT_FAILURE);
+            expect(results[0].message.find("v1.0.0..HEAD") != std::string::npos)
+                    << results[0].message;
+            expect(that % results[1].exitCode == EXIT_SUCCESS) << results[1].message;
+        };
+
+        std::filesystem::remove_all(root);
+    };
+
+    git_libgit2_shutdown();
+}
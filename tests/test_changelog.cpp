@@ -65,6 +65,16 @@ const std::vector<GenerateTestData> testdata2 = {
             { "feat", "", "major refactor of JSON schema", "7b9af4b", false, true, false },
             { "fix", "", "handle trailing commas in csv header", "cc2ce84", false, false, true },
         }
+    },
+    {
+        {"link issues and pull requests"},
+        { CHANGELOG_DIR "create-new.md" },
+        {1,1,0},
+        {1,0,0},
+        { "https://github.com/Symbitic/QSqlTest" },
+        {
+            { "feat", "", "add a walk mode", "7b9af4b", false, true, false, { 12, 45 } },
+        }
     }
     // clang-format on
 };
@@ -100,10 +110,32 @@ int main()
                         << "there were no errors while generating";
                 expect(that % log.data().length() > static_cast<unsigned long>(0))
                         << "the data has been generated";
+                for (const auto &commit : testcase.commits) {
+                    for (const auto number : commit.references) {
+                        const auto link = testcase.url + "/issues/" + std::to_string(number);
+                        expect(log.data().find(link) != std::string::npos) << "links" << link;
+                    }
+                }
 
                 //
                 // TODO: Read and compare to the file.
             };
         }
+
+        it("should insert a rendered release as generate() does") = [] {
+            const auto &testcase = testdata2.front();
+            const auto table = IConventionalCommit::toTable(testcase.commits);
+
+            TestChangelog generated;
+            generated.read();
+            generated.generate(testcase.current, testcase.previous, table, testcase.url);
+
+            TestChangelog inserted;
+            inserted.read();
+            inserted.insertRelease(inserted.renderRelease(testcase.current, testcase.previous,
+                                                          table, testcase.url));
+
+            expect(that % inserted.data() == generated.data());
+        };
     };
 }
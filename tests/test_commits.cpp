@@ -0,0 +1,414 @@
+#include "boost/ut.hpp"
+#include "standard-release/commits/conventional.h"
+#include "standard-release/commits/references.h"
+#include "standard-release/commits/table.h"
+#include "standard-release/commits/types.h"
+#include "standard-release/git/repository.h"
+#include "standard-release/semver/semver.h"
+#include <string>
+#include <vector>
+
+using namespace boost::ut;
+using namespace boost::ut::spec;
+using namespace StandardRelease;
+
+struct BumpTestData
+{
+    std::vector<std::string> summaries;
+    SemVer expected;
+};
+
+const std::vector<BumpTestData> bumpdata = {
+    // clang-format off
+    { { "docs: describe the index", "chore: tidy" }, { 1, 0, 0 } },
+    { { "fix: handle commas", "docs: describe the index" }, { 1, 0, 1 } },
+    { { "fix: handle commas", "feat(core): add a walk mode" }, { 1, 1, 0 } },
+    { { "feat: add a walk mode", "refactor!: drop the loader" }, { 2, 0, 0 } },
+    // clang-format on
+};
+
+int main()
+{
+    "CommitTable"_test = [] {
+        it("should store every field of a commit") = [] {
+            CommitTable table;
+            table.append(CommitTable::Feat, "core", "add a walk mode", "abc1234",
+                         CommitTable::Feature);
+            table.append(CommitTable::Fix, "", "handle commas", "def5678", CommitTable::Bugfix);
+
+            expect(that % table.size() == static_cast<size_t>(2));
+            expect(table.type(0) == CommitTable::Feat);
+            expect(that % table.scope(0) == std::string_view("core"));
+            expect(that % table.subject(0) == std::string_view("add a walk mode"));
+            expect(that % table.hash(0) == std::string_view("abc1234"));
+            expect(that % table.scopeId(1) == static_cast<uint32_t>(0)) << "no scope";
+            expect(that % table.subject(1) == std::string_view("handle commas"));
+        };
+
+        it("should keep references with their rows when reversed") = [] {
+            CommitTable table;
+            table.append(CommitTable::Feat, "", "a", "", 0, { 12, 45 });
+            table.append(CommitTable::Fix, "", "b");
+            table.append(CommitTable::Fix, "", "c", "", 0, { 7 });
+            table.reverse();
+
+            expect(that % table.referenceCount(0) == static_cast<size_t>(1));
+            expect(that % table.reference(0, 0) == static_cast<uint32_t>(7));
+            expect(that % table.referenceCount(1) == static_cast<size_t>(0));
+            expect(table.references(2) == std::vector<uint32_t> { 12, 45 });
+        };
+
+        it("should intern scopes") = [] {
+            CommitTable table;
+            table.append(CommitTable::Feat, "core", "a");
+            table.append(CommitTable::Fix, "git", "b");
+            table.append(CommitTable::Perf, "core", "c");
+
+            expect(that % table.scopeId(0) == table.scopeId(2));
+            expect(that % table.scopeId(0) != table.scopeId(1));
+            expect(that % table.scopes().size() == static_cast<size_t>(3));
+        };
+
+        it("should group rows by type in order") = [] {
+            CommitTable table;
+            table.append(CommitTable::Fix, "", "fix 1");
+            table.append(CommitTable::Feat, "", "feat 1");
+            table.append(CommitTable::Fix, "", "fix 2");
+            table.append(CommitTable::Docs, "", "docs 1");
+            table.append(CommitTable::Feat, "", "feat 2");
+
+            const auto groups = table.groupByType();
+            expect(that % groups.count(CommitTable::Feat) == static_cast<uint32_t>(2));
+            expect(that % groups.count(CommitTable::Fix) == static_cast<uint32_t>(2));
+            expect(that % groups.count(CommitTable::Perf) == static_cast<uint32_t>(0));
+
+            const auto fix = groups.begin[CommitTable::Fix];
+            expect(that % table.subject(groups.rows[fix]) == std::string_view("fix 1"));
+            expect(that % table.subject(groups.rows[fix + 1]) == std::string_view("fix 2"));
+        };
+
+        it("should split comma-separated scopes") = [] {
+            CommitTable table;
+            table.append(CommitTable::Fix, "core ,git/refs", "a");
+            table.append(CommitTable::Fix, "git/refs", "b");
+
+            expect(that % table.scopeCount(0) == static_cast<size_t>(2));
+            expect(that % table.scope(0) == std::string_view("core, git/refs"));
+            expect(that % table.scopeId(0, 1) == table.scopeId(1));
+            expect(that % table.scopeId(1, 1) == static_cast<uint32_t>(0));
+        };
+
+        it("should sort rows by scope") = [] {
+            CommitTable table;
+            table.append(CommitTable::Feat, "git", "1");
+            table.append(CommitTable::Feat, "core", "2");
+            table.append(CommitTable::Feat, "", "3");
+            table.append(CommitTable::Feat, "git", "4");
+            table.append(CommitTable::Feat, "core, git", "5");
+
+            std::vector<uint32_t> rows { 0, 1, 2, 3, 4 };
+            table.sortByScope(rows);
+
+            std::string order;
+            for (const auto row : rows) {
+                order += table.subject(row);
+            }
+            expect(that % order == std::string("32514"));
+        };
+
+        it("should reverse rows") = [] {
+            CommitTable table;
+            table.append(CommitTable::Feat, "a", "first", "", CommitTable::Feature);
+            table.append(CommitTable::Fix, "b", "second", "", CommitTable::Bugfix);
+            table.reverse();
+
+            expect(that % table.subject(0) == std::string_view("second"));
+            expect(that % table.scope(0) == std::string_view("b"));
+            expect(that % table.flags(1) == static_cast<uint8_t>(CommitTable::Feature));
+            expect(that % table.scope(1) == std::string_view("a"));
+            expect(that % table.scopes()[table.scopeId(0)] == std::string("b"));
+        };
+    };
+
+    "References"_test = [] {
+        it("should find issue and pull request references") = [] {
+            std::vector<uint32_t> numbers;
+            findReferences("Closes #45, fixes GH-7 and gh-8.\n#123", numbers);
+            expect(numbers == std::vector<uint32_t> { 45, 7, 8, 123 });
+        };
+
+        it("should ignore other repositories and glued numbers") = [] {
+            std::vector<uint32_t> numbers;
+            findReferences("owner/repo#1 abc#2 &#3; #4x #0 #1234567890 XGH-5 #", numbers);
+            expect(that % numbers.size() == static_cast<size_t>(0));
+        };
+
+        it("should find references across and around 16 byte blocks") = [] {
+            // Places an anchor at every offset of a block and at the end of the text.
+            for (size_t offset = 0; offset < 40; offset++) {
+                std::vector<uint32_t> numbers;
+                findReferences(std::string(offset, ' ') + "#9 " + std::string(20, '-') + " GH-10",
+                               numbers);
+                expect(numbers == std::vector<uint32_t> { 9, 10 }) << "offset" << offset;
+            }
+        };
+    };
+
+    "CommitTypes"_test = [] {
+        it("should find the standard types") = [] {
+            const auto &types = CommitTypes::defaults();
+            expect(that % types.find("feat") == static_cast<int>(CommitTable::Feat));
+            expect(that % types.find("test") == static_cast<int>(CommitTable::Test));
+            expect(that % types.find("feature") == -1);
+            expect(that % types.find("") == -1);
+            expect(that % types.sections().size() == static_cast<size_t>(4));
+        };
+
+        it("should add and override types") = [] {
+            CommitTypes types;
+            expect(types.set("deps", "Dependencies", CommitTypes::Patch));
+            expect(types.set("docs", "Documentation", CommitTypes::NoBump));
+
+            const int deps = types.find("deps");
+            expect(that % deps == static_cast<int>(CommitTable::TypeCount));
+            expect(that % types.flags(deps) == static_cast<uint8_t>(CommitTable::Bugfix));
+            expect(that % types.type(CommitTable::Docs).section == std::string("Documentation"));
+            expect(that % types.find("feat") == static_cast<int>(CommitTable::Feat));
+        };
+
+        it("should find every type of a full table") = [] {
+            CommitTypes types;
+            for (int i = CommitTable::TypeCount; i < CommitTable::MaxTypes; i++) {
+                expect(types.set("type" + std::to_string(i), "", CommitTypes::NoBump));
+            }
+            expect(!types.set("onemore", "", CommitTypes::NoBump)) << "table is full";
+
+            for (int i = 0; i < CommitTable::MaxTypes; i++) {
+                expect(that % types.find(types.type(i).name) == i);
+            }
+        };
+    };
+
+    "ConventionalCommits"_test = [] {
+        for (const auto &testcase : bumpdata) {
+            it("should bump to " + testcase.expected.str()) = [testcase] {
+                GitRepository::Commits commits;
+                for (const auto &summary : testcase.summaries) {
+                    commits.push_back(GitRepository::Commit(summary.c_str()));
+                }
+
+                ConventionalCommits conventional;
+                conventional.setVersion(SemVer(1, 0, 0));
+                conventional.parseCommits(commits);
+                conventional.bump();
+                expect(conventional.version() == testcase.expected);
+            };
+        }
+
+        it("should bump from configured types") = [] {
+            CommitTypes types;
+            types.set("deps", "Dependencies", CommitTypes::Minor);
+
+            ConventionalCommits conventional;
+            conventional.setTypes(types);
+            conventional.setVersion(SemVer(1, 0, 0));
+            conventional.parseCommits({ GitRepository::Commit("deps: bump libgit2") });
+            expect(conventional.error() == Error::Success);
+            conventional.bump();
+            expect(conventional.version() == SemVer(1, 1, 0));
+        };
+
+        it("should reject unknown types") = [] {
+            ConventionalCommits conventional;
+            conventional.parseCommits({ GitRepository::Commit("deps: bump libgit2") });
+            expect(conventional.error() == Error::ConventionalUnrecognizedType);
+        };
+
+        it("should parse several scopes") = [] {
+            ConventionalCommits conventional;
+            conventional.parseCommits({ GitRepository::Commit("fix(core, git/refs): a"),
+                                        GitRepository::Commit("feat(ci-cd): b") });
+
+            const auto &table = conventional.table();
+            expect(that % table.size() == static_cast<size_t>(2));
+            expect(that % table.scope(0) == std::string_view("ci-cd"));
+            expect(that % table.scope(1) == std::string_view("core, git/refs"));
+            expect(that % table.scopeCount(1) == static_cast<size_t>(2));
+        };
+
+        it("should list a repeated change once") = [] {
+            GitRepository::Commits commits = {
+                GitRepository::Commit("fix: handle commas (backport)", "", "3333333"),
+                GitRepository::Commit("feat: add a walk mode", "", "2222222"),
+                GitRepository::Commit("fix: handle commas", "", "1111111"),
+            };
+            commits.front().patchId = "5f1e";
+            commits.back().patchId = "5f1e";
+
+            ConventionalCommits conventional;
+            conventional.parseCommits(commits);
+
+            const auto &table = conventional.table();
+            expect(that % table.size() == static_cast<size_t>(2));
+            expect(that % table.hash(1) == std::string_view("3333333")) << "newest copy kept";
+        };
+
+        it("should drop a revert together with the commit it reverts") = [] {
+            const std::string feat(40, 'a');
+            const std::string fix(40, 'b');
+            const GitRepository::Commits commits = {
+                GitRepository::Commit("revert: feat: add a walk mode",
+                                      ("This reverts commit " + feat + ".").c_str(), "ccccccc",
+                                      std::string(40, 'c').c_str()),
+                GitRepository::Commit("fix: handle commas", "", "bbbbbbb", fix.c_str()),
+                GitRepository::Commit("feat: add a walk mode", "", "aaaaaaa", feat.c_str()),
+            };
+
+            ConventionalCommits conventional;
+            conventional.setVersion(SemVer(1, 0, 0));
+            conventional.parseCommits(commits);
+
+            const auto &table = conventional.table();
+            expect(that % table.size() == static_cast<size_t>(1));
+            expect(that % table.hash(0) == std::string_view("bbbbbbb"));
+            conventional.bump();
+            expect(conventional.version() == SemVer(1, 0, 1)) << "reverted feature does not bump";
+        };
+
+        it("should keep a commit whose revert was reverted") = [] {
+            const std::string feat(40, 'a');
+            const std::string revert(40, 'b');
+            const GitRepository::Commits commits = {
+                GitRepository::Commit("Revert \"revert: feat: add a walk mode\"",
+                                      ("This reverts commit " + revert + ".").c_str(), "ccccccc",
+                                      std::string(40, 'c').c_str()),
+                GitRepository::Commit("revert: feat: add a walk mode",
+                                      ("This reverts commit " + feat + ".").c_str(), "bbbbbbb",
+                                      revert.c_str()),
+                GitRepository::Commit("feat: add a walk mode", "", "aaaaaaa", feat.c_str()),
+                GitRepository::Commit("chore(release): 1.0.0"),
+                GitRepository::Commit("fix: released earlier", "", "9999999",
+                                      std::string(40, '9').c_str()),
+            };
+
+            ConventionalCommits conventional;
+            conventional.parseCommits(commits);
+
+            const auto &table = conventional.table();
+            expect(that % table.size() == static_cast<size_t>(1));
+            expect(that % table.hash(0) == std::string_view("aaaaaaa"));
+        };
+
+        it("should list a revert of an earlier release") = [] {
+            const GitRepository::Commits commits = {
+                GitRepository::Commit("revert: fix: released earlier",
+                                      ("This reverts commit " + std::string(40, '9') + ".").c_str(),
+                                      "ccccccc", std::string(40, 'c').c_str()),
+                GitRepository::Commit("chore(release): 1.0.0"),
+                GitRepository::Commit("fix: released earlier", "", "9999999",
+                                      std::string(40, '9').c_str()),
+            };
+
+            ConventionalCommits conventional;
+            conventional.parseCommits(commits);
+
+            const auto &table = conventional.table();
+            expect(that % table.size() == static_cast<size_t>(1));
+            expect(that % table.type(0) == CommitTable::Revert);
+        };
+
+        it("should collect references from the subject and body") = [] {
+            ConventionalCommits conventional;
+            conventional.parseCommits({ GitRepository::Commit(
+                    "fix: handle commas (#31)", "Refs #7 and GH-31.\n\nCloses #2", "1111111") });
+
+            const auto &table = conventional.table();
+            expect(that % table.subject(0) == std::string_view("handle commas"));
+            expect(table.references(0) == std::vector<uint32_t> { 2, 7, 31 });
+            expect(conventional.commits()[0].references == std::vector<uint32_t> { 2, 7, 31 });
+        };
+
+        it("should expand the commits listed in a squash merge") = [] {
+            const GitRepository::Commits commits = {
+                GitRepository::Commit("Merge the walk modes (#12)",
+                                      "* feat(git): add a walk mode\n\n"
+                                      "* fix: handle commas (#9)\n\n"
+                                      "* wip: not a type\n"
+                                      "- perf!: drop the cache\n\n"
+                                      "Co-authored-by: someone",
+                                      "2222222"),
+                GitRepository::Commit("feat: add a config file", "* fix: listed in the body",
+                                      "1111111"),
+            };
+
+            ConventionalCommits conventional;
+            conventional.parseCommits(commits);
+            expect(that % conventional.table().size() == static_cast<size_t>(1))
+                    << "off by default";
+
+            conventional.setExpandSquashes(true);
+            conventional.parseCommits(commits);
+
+            const auto &table = conventional.table();
+            expect(that % table.size() == static_cast<size_t>(5));
+            expect(that % table.subject(0) == std::string_view("add a config file"));
+            expect(that % table.subject(1) == std::string_view("listed in the body"));
+            expect(that % table.subject(2) == std::string_view("add a walk mode"));
+            expect(that % table.scope(2) == std::string_view("git"));
+            expect(that % table.subject(3) == std::string_view("handle commas"));
+            expect(table.references(3) == std::vector<uint32_t> { 9 });
+            expect(that % table.hash(4) == std::string_view("2222222"));
+            expect(that % table.flags(4) == static_cast<uint8_t>(CommitTable::Breaking));
+        };
+
+        it("should append commits made after the last parse") = [] {
+            ConventionalCommits conventional;
+            conventional.setVersion(SemVer(1, 0, 0));
+            conventional.parseCommits(
+                    { GitRepository::Commit("fix: handle commas", "", "1111111") });
+
+            expect(conventional.appendCommits({
+                    GitRepository::Commit("feat: add a walk mode", "", "3333333"),
+                    GitRepository::Commit("docs: explain walk modes", "", "2222222"),
+            }));
+
+            const auto &table = conventional.table();
+            expect(that % table.size() == static_cast<size_t>(3));
+            expect(that % table.hash(2) == std::string_view("3333333")) << "newest row last";
+            conventional.bump();
+            expect(conventional.version() == SemVer(1, 1, 0));
+        };
+
+        it("should refuse to append commits that change earlier entries") = [] {
+            const std::string fix(40, '1');
+            ConventionalCommits conventional;
+            conventional.parseCommits(
+                    { GitRepository::Commit("fix: handle commas", "", "1111111", fix.c_str()) });
+
+            expect(!conventional.appendCommits({ GitRepository::Commit(
+                    "revert: fix: handle commas",
+                    ("This reverts commit " + fix + ".").c_str(), "2222222") }));
+            expect(!conventional.appendCommits({ GitRepository::Commit("chore(release): 1.0.1") }));
+            expect(that % conventional.table().size() == static_cast<size_t>(1))
+                    << "table is unchanged";
+        };
+
+        it("should keep the vector API in commit order") = [] {
+            const GitRepository::Commits commits = {
+                GitRepository::Commit("feat(core): newest", "", "2222222"),
+                GitRepository::Commit("fix: oldest", "BREAKING CHANGE: gone", "1111111"),
+            };
+
+            ConventionalCommits conventional;
+            conventional.parseCommits(commits);
+
+            const auto parsed = conventional.commits();
+            expect(that % parsed.size() == static_cast<size_t>(2));
+            expect(that % parsed[0].type == std::string("fix"));
+            expect(parsed[0].breaking && parsed[0].bugfix);
+            expect(that % parsed[1].scope == std::string("core"));
+            expect(that % parsed[1].hash == std::string("2222222"));
+            expect(parsed[1].feature);
+        };
+    };
+}
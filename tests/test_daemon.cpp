@@ -0,0 +1,176 @@
+#include "boost/ut.hpp"
+#include "git2.h"
+#include "standard-release/daemon/daemon.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace boost::ut;
+using namespace boost::ut::spec;
+using namespace StandardRelease;
+
+static void writeFile(const std::filesystem::path &path, const std::string &contents)
+{
+    std::ofstream out(path);
+    out << contents;
+}
+
+// Commit every file in the working directory.
+static void commitAll(const std::filesystem::path &dir, const std::string &msg)
+{
+    git_repository *repo = nullptr;
+    git_index *index = nullptr;
+    git_tree *tree = nullptr;
+    git_signature *sig = nullptr;
+    git_object *parent = nullptr;
+    git_oid treeOid;
+    git_oid commitOid;
+
+    git_repository_open(&repo, dir.string().c_str());
+    git_repository_index(&index, repo);
+    git_index_add_all(index, nullptr, GIT_INDEX_ADD_DEFAULT, nullptr, nullptr);
+    git_index_write_tree(&treeOid, index);
+    git_index_write(index);
+    git_tree_lookup(&tree, repo, &treeOid);
+    git_signature_default(&sig, repo);
+
+    if (git_revparse_single(&parent, repo, "HEAD") == GIT_OK) {
+        const git_commit *parents[] = { reinterpret_cast<git_commit *>(parent) };
+        git_commit_create(&commitOid, repo, "HEAD", sig, sig, nullptr, msg.c_str(), tree, 1,
+                          parents);
+    } else {
+        git_commit_create(&commitOid, repo, "HEAD", sig, sig, nullptr, msg.c_str(), tree, 0,
+                          nullptr);
+    }
+
+    git_object_free(parent);
+    git_signature_free(sig);
+    git_tree_free(tree);
+    git_index_free(index);
+    git_repository_free(repo);
+}
+
+// Connected client socket, or -1.
+static int connectTo(const std::filesystem::path &socketPath)
+{
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    socketPath.string().copy(address.sun_path, sizeof(address.sun_path) - 1);
+
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// One `OK` reply, or whatever arrives before the daemon closes the connection.
+static std::string receive(int fd)
+{
+    std::string input;
+    char buffer[256];
+    ssize_t length;
+    while ((length = ::recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        input.append(buffer, length);
+        const size_t header = input.find('\n');
+        if (header != std::string::npos
+            && input.size() >= header + 1 + std::stoul(input.substr(3, header - 3))) {
+            break;
+        }
+    }
+    return input;
+}
+
+// Repository at version 1.0.0 with nothing to release yet.
+static void createProject(const std::filesystem::path &dir)
+{
+    git_repository *repo = nullptr;
+    git_config *config = nullptr;
+
+    std::filesystem::create_directories(dir);
+    git_repository_init(&repo, dir.string().c_str(), 0);
+    git_repository_config(&config, repo);
+    git_config_set_string(config, "user.name", "Standard Release");
+    git_config_set_string(config, "user.email", "release@example.com");
+    git_config_free(config);
+    git_repository_free(repo);
+
+    writeFile(dir / "release.yml", "releaseType: text\n");
+    writeFile(dir / "VERSION.txt", "1.0.0\n");
+    commitAll(dir, "chore: initial commit");
+}
+
+int main()
+{
+    git_libgit2_init();
+
+    "Daemon"_test = [] {
+        const auto root = std::filesystem::temp_directory_path() / "standard-release-daemon";
+        std::filesystem::remove_all(root);
+
+        it("should update the preview when a commit is added") = [root] {
+            const auto dir = root / "app";
+            createProject(dir);
+
+            Daemon daemon;
+            expect(daemon.addRepository(dir.string())) << daemon.error().message();
+            expect(that % daemon.query("version") == std::string("OK 6\n1.0.0\n"));
+
+            writeFile(dir / "src.txt", "src\n");
+            commitAll(dir, "feat: add a walk mode");
+            daemon.refresh();
+
+            expect(that % daemon.query("version") == std::string("OK 6\n1.1.0\n"));
+            expect(that % daemon.query("current " + dir.string())
+                   == std::string("OK 6\n1.0.0\n"));
+            const auto changelog = daemon.query("changelog");
+            expect(changelog.rfind("OK ", 0) == 0) << changelog;
+            expect(changelog.find("add a walk mode") != std::string::npos) << changelog;
+        };
+
+        it("should reject unknown requests") = [root] {
+            const auto dir = root / "lib";
+            createProject(dir);
+
+            Daemon daemon;
+            expect(daemon.addRepository(dir.string())) << daemon.error().message();
+            expect(daemon.query("bump").rfind("ERR ", 0) == 0);
+            expect(daemon.query("version " + (root / "missing").string()).rfind("ERR ", 0) == 0);
+        };
+
+        it("should drop a client whose request is too long") = [root] {
+            const auto dir = root / "socket";
+            createProject(dir);
+
+            Daemon daemon;
+            expect(daemon.addRepository(dir.string())) << daemon.error().message();
+            expect(daemon.listen(root / "daemon.sock")) << daemon.error().message();
+            std::thread server([&daemon] { daemon.run(); });
+
+            const int client = connectTo(root / "daemon.sock");
+            const int flooder = connectTo(root / "daemon.sock");
+            expect(client >= 0 && flooder >= 0);
+
+            const std::string flood(16 * 1024, 'x');
+            ::send(flooder, flood.data(), flood.size(), MSG_NOSIGNAL);
+            expect(receive(flooder).empty()) << "the connection is closed without a reply";
+
+            ::send(client, "version\n", 8, MSG_NOSIGNAL);
+            expect(that % receive(client) == std::string("OK 6\n1.0.0\n"));
+
+            ::close(flooder);
+            ::close(client);
+            daemon.stop();
+            server.join();
+        };
+
+        std::filesystem::remove_all(root);
+    };
+
+    git_libgit2_shutdown();
+}
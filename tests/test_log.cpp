@@ -0,0 +1,149 @@
+#include "boost/ut.hpp"
+#include "standard-release/log/async.h"
+#include "standard-release/log/ilog.h"
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace boost::ut;
+using namespace boost::ut::spec;
+using namespace StandardRelease;
+
+/** Everything written to a temporary file so far. */
+static std::string contents(std::FILE *file)
+{
+    std::string text;
+    char buf[4096];
+    size_t count;
+
+    std::rewind(file);
+    while ((count = std::fread(buf, 1, sizeof(buf), file)) > 0) {
+        text.append(buf, count);
+    }
+    std::fseek(file, 0, SEEK_END);
+    return text;
+}
+
+static size_t countLines(const std::string &text)
+{
+    size_t lines = 0;
+    for (const char c : text) {
+        lines += c == '\n' ? 1 : 0;
+    }
+    return lines;
+}
+
+int main()
+{
+    "ILogger"_test = [] {
+        it("should not evaluate messages below the logger level") = [] {
+            std::FILE *file = std::tmpfile();
+            AsyncLogger logger(file);
+            logger.setLevel(ILogger::Info);
+            ILogger::setInstance(&logger);
+
+            int evaluated = 0;
+            const auto expensive = [&evaluated] { return ++evaluated; };
+
+            srDebug(lcGit()) << "skipped " << expensive();
+            srInfo(lcGit()) << "written " << expensive();
+            logger.flush();
+
+            const auto text = contents(file);
+            expect(that % evaluated == 1);
+            expect(that % text.find("info git: written 1") != std::string::npos) << text;
+            expect(that % text.find("skipped") == std::string::npos);
+
+            ILogger::setInstance(nullptr);
+            std::fclose(file);
+        };
+
+        it("should filter by category") = [] {
+            std::FILE *file = std::tmpfile();
+            AsyncLogger logger(file);
+            LogCategory quiet("quiet", ILogger::Warning);
+            logger.setLevel(ILogger::Debug);
+            ILogger::setInstance(&logger);
+
+            srInfo(quiet) << "hidden";
+            srWarning(quiet) << "shown";
+            logger.flush();
+
+            const auto text = contents(file);
+            expect(that % text.find("hidden") == std::string::npos);
+            expect(that % text.find("warning quiet: shown") != std::string::npos) << text;
+
+            ILogger::setInstance(nullptr);
+            std::fclose(file);
+        };
+
+        it("should truncate long messages") = [] {
+            std::FILE *file = std::tmpfile();
+            AsyncLogger logger(file);
+            ILogger::setInstance(&logger);
+
+            srCritical(lcRelease()) << std::string(1000, 'x');
+            logger.flush();
+
+            const auto text = contents(file);
+            expect(that % text.find(std::string(LogMessage::MaxLength, 'x')) != std::string::npos);
+            expect(that % text.find(std::string(LogMessage::MaxLength + 1, 'x'))
+                   == std::string::npos);
+
+            ILogger::setInstance(nullptr);
+            std::fclose(file);
+        };
+    };
+
+    "AsyncLogger"_test = [] {
+        it("should write every message from concurrent threads") = [] {
+            const int threads = 4;
+            const int messages = 5000;
+            std::FILE *file = std::tmpfile();
+            AsyncLogger logger(file, threads * messages);
+            logger.setLevel(ILogger::Debug);
+            logger.open();
+            ILogger::setInstance(&logger);
+
+            std::vector<std::thread> writers;
+            for (int t = 0; t < threads; t++) {
+                writers.emplace_back([t] {
+                    for (int i = 0; i < messages; i++) {
+                        srDebug(lcCommits()) << "thread " << t << " message " << i;
+                    }
+                });
+            }
+            for (auto &writer : writers) {
+                writer.join();
+            }
+            logger.flush();
+
+            expect(that % logger.dropped() == static_cast<size_t>(0));
+            expect(that % countLines(contents(file)) == static_cast<size_t>(threads * messages));
+
+            ILogger::setInstance(nullptr);
+            std::fclose(file);
+        };
+
+        it("should drop messages instead of blocking when full") = [] {
+            std::FILE *file = std::tmpfile();
+            AsyncLogger logger(file, 16);
+            ILogger::setInstance(&logger);
+
+            // Not opened yet, so nothing drains the ring.
+            for (int i = 0; i < 100; i++) {
+                srInfo(lcGit()) << i;
+            }
+
+            expect(that % logger.capacity() == static_cast<size_t>(16));
+            expect(that % logger.dropped() == static_cast<size_t>(84));
+
+            logger.flush();
+            expect(that % countLines(contents(file)) == static_cast<size_t>(16));
+
+            ILogger::setInstance(nullptr);
+            std::fclose(file);
+        };
+    };
+}
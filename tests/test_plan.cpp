@@ -0,0 +1,63 @@
+#include "boost/ut.hpp"
+#include "standard-release/plan/plan.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace boost::ut;
+using namespace boost::ut::spec;
+using namespace StandardRelease;
+
+int main()
+{
+    "ReleasePlan"_test = [] {
+        const auto file = std::filesystem::temp_directory_path() / "standard-release-plan.json";
+
+        it("should read back what it writes") = [file] {
+            CommitTable commits;
+            commits.append(CommitTable::Fix, "core, git/refs", "handle \"quoted\" commas",
+                           "1111111", CommitTable::Bugfix, { 12, 40 });
+            commits.append(CommitTable::Feat, "", "add a walk mode\twith tabs", "2222222",
+                           CommitTable::Feature | CommitTable::Breaking);
+
+            ReleasePlan plan;
+            plan.setHead(std::string(40, 'a'));
+            plan.setOldVersion(SemVer(1, 2, 3));
+            plan.setNewVersion(SemVer(2, 0, 0));
+            plan.setCommits(commits);
+            plan.setChangelog("## [2.0.0](url) (2024-01-01)\n\n### Features\n\n* add \\ slash\n");
+            plan.setFiles({ "CHANGELOG.md", "package.json" });
+            expect(plan.save(file));
+
+            ReleasePlan loaded;
+            expect(loaded.load(file)) << loaded.error().message();
+            expect(that % loaded.head() == plan.head());
+            expect(loaded.oldVersion() == SemVer(1, 2, 3));
+            expect(loaded.newVersion() == SemVer(2, 0, 0));
+            expect(that % loaded.changelog() == plan.changelog());
+            expect(loaded.files() == plan.files());
+
+            const auto &table = loaded.commits();
+            expect(that % table.size() == static_cast<size_t>(2));
+            expect(that % table.type(0) == CommitTable::Fix);
+            expect(that % table.scopeCount(0) == static_cast<size_t>(2));
+            expect(that % table.subject(0) == std::string_view("handle \"quoted\" commas"));
+            expect(table.references(0) == std::vector<uint32_t> { 12, 40 });
+            expect(that % table.subject(1) == std::string_view("add a walk mode\twith tabs"));
+            expect((table.flags(1) & CommitTable::Breaking) != 0);
+            expect(that % table.combinedFlags() == plan.commits().combinedFlags());
+        };
+
+        it("should reject a file that is not a plan") = [file] {
+            std::ofstream out(file);
+            out << "{\"format\": 99}\n";
+            out.close();
+
+            ReleasePlan plan;
+            expect(!plan.load(file));
+            expect(plan.error().message().find("Invalid release plan") != std::string::npos);
+        };
+
+        std::filesystem::remove(file);
+    };
+}
@@ -0,0 +1,648 @@
+#include "boost/ut.hpp"
+#include "git2.h"
+#include "standard-release/errors/errors.h"
+#include "standard-release/git/bloom.h"
+#include "standard-release/git/cachefile.h"
+#include "standard-release/git/oidindex.h"
+#include "standard-release/git/patchid.h"
+#include "standard-release/git/repository.h"
+#include "standard-release/tasks/scheduler.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+
+using namespace boost::ut;
+using namespace boost::ut::spec;
+using namespace StandardRelease;
+
+/**
+ * @brief Working repository with a local bare repository as its `origin`.
+ * @details The bare repository stands in for a real remote over `file://`.
+ */
+struct TestRepos
+{
+    std::filesystem::path root;
+    std::filesystem::path work;
+    std::filesystem::path bare;
+
+    TestRepos(const std::string &name)
+    {
+        root = std::filesystem::temp_directory_path() / ("standard-release-" + name);
+        work = root / "work";
+        bare = root / "origin.git";
+
+        std::filesystem::remove_all(root);
+        std::filesystem::create_directories(work);
+
+        git_libgit2_init();
+
+        git_repository *remoteRepo = nullptr;
+        git_repository_init(&remoteRepo, bare.string().c_str(), 1);
+        git_repository_free(remoteRepo);
+
+        git_repository *repo = nullptr;
+        git_config *config = nullptr;
+        git_remote *remote = nullptr;
+        git_repository_init(&repo, work.string().c_str(), 0);
+        git_repository_config(&config, repo);
+        git_config_set_string(config, "user.name", "Standard Release");
+        git_config_set_string(config, "user.email", "release@example.com");
+        git_config_free(config);
+
+        const std::string url = "file://" + bare.string();
+        git_remote_create(&remote, repo, "origin", url.c_str());
+        git_remote_free(remote);
+        git_repository_free(repo);
+    }
+
+    ~TestRepos()
+    {
+        git_libgit2_shutdown();
+        std::filesystem::remove_all(root);
+    }
+
+    void commitFile(const std::string &file, const std::string &contents, const std::string &msg)
+    {
+        git_repository *repo = nullptr;
+        git_index *index = nullptr;
+        git_tree *tree = nullptr;
+        git_signature *sig = nullptr;
+        git_object *parent = nullptr;
+        git_oid treeOid;
+        git_oid commitOid;
+
+        std::filesystem::create_directories((work / file).parent_path());
+        std::ofstream out(work / file);
+        out << contents;
+        out.close();
+
+        git_repository_open(&repo, work.string().c_str());
+        git_repository_index(&index, repo);
+        git_index_add_bypath(index, file.c_str());
+        git_index_write_tree(&treeOid, index);
+        git_index_write(index);
+        git_tree_lookup(&tree, repo, &treeOid);
+        git_signature_default(&sig, repo);
+
+        if (git_revparse_single(&parent, repo, "HEAD") == GIT_OK) {
+            const git_commit *parents[] = { reinterpret_cast<git_commit *>(parent) };
+            git_commit_create(&commitOid, repo, "HEAD", sig, sig, nullptr, msg.c_str(), tree, 1,
+                              parents);
+        } else {
+            git_commit_create(&commitOid, repo, "HEAD", sig, sig, nullptr, msg.c_str(), tree, 0,
+                              nullptr);
+        }
+
+        git_object_free(parent);
+        git_signature_free(sig);
+        git_tree_free(tree);
+        git_index_free(index);
+        git_repository_free(repo);
+    }
+
+    std::string headId()
+    {
+        git_repository *repo = nullptr;
+        git_oid oid;
+        char id[GIT_OID_HEXSZ + 1];
+
+        git_repository_open(&repo, work.string().c_str());
+        git_reference_name_to_id(&oid, repo, "HEAD");
+        git_repository_free(repo);
+
+        return git_oid_tostr(id, sizeof(id), &oid);
+    }
+
+    // Commit the tree at `HEAD` with the given parents and move the branch to it.
+    std::string commitWithParents(const std::vector<std::string> &parentIds,
+                                  const std::string &msg)
+    {
+        git_repository *repo = nullptr;
+        git_object *head = nullptr;
+        git_tree *tree = nullptr;
+        git_signature *sig = nullptr;
+        git_reference *ref = nullptr;
+        std::vector<git_commit *> parents;
+        git_oid commitOid;
+        char id[GIT_OID_HEXSZ + 1];
+
+        git_repository_open(&repo, work.string().c_str());
+        git_revparse_single(&head, repo, "HEAD^{tree}");
+        tree = reinterpret_cast<git_tree *>(head);
+        git_signature_default(&sig, repo);
+        for (const auto &parentId : parentIds) {
+            git_oid oid;
+            git_commit *parent = nullptr;
+            git_oid_fromstr(&oid, parentId.c_str());
+            git_commit_lookup(&parent, repo, &oid);
+            parents.push_back(parent);
+        }
+
+        git_commit_create(&commitOid, repo, nullptr, sig, sig, nullptr, msg.c_str(), tree,
+                          parents.size(), const_cast<const git_commit **>(parents.data()));
+        git_reference_create(&ref, repo, headName().c_str(), &commitOid, 1, nullptr);
+
+        for (auto *parent : parents) {
+            git_commit_free(parent);
+        }
+        git_reference_free(ref);
+        git_signature_free(sig);
+        git_tree_free(tree);
+        git_repository_free(repo);
+
+        return git_oid_tostr(id, sizeof(id), &commitOid);
+    }
+
+    void setIdentity(const std::string &name)
+    {
+        git_repository *repo = nullptr;
+        git_config *config = nullptr;
+
+        git_repository_open(&repo, work.string().c_str());
+        git_repository_config(&config, repo);
+        git_config_set_string(config, "user.name", name.c_str());
+        git_config_free(config);
+        git_repository_free(repo);
+    }
+
+    bool remoteHasRef(const std::string &name)
+    {
+        git_repository *repo = nullptr;
+        git_reference *ref = nullptr;
+
+        git_repository_open(&repo, bare.string().c_str());
+        const int ret = git_reference_lookup(&ref, repo, name.c_str());
+        git_reference_free(ref);
+        git_repository_free(repo);
+
+        return ret == GIT_OK;
+    }
+
+    size_t packCount()
+    {
+        size_t count = 0;
+        for (const auto &entry : std::filesystem::directory_iterator(work / ".git/objects/pack")) {
+            if (entry.path().extension() == ".pack") {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    std::string headName()
+    {
+        git_repository *repo = nullptr;
+        git_reference *head = nullptr;
+
+        git_repository_open(&repo, work.string().c_str());
+        git_repository_head(&head, repo);
+        const std::string name = git_reference_name(head);
+        git_reference_free(head);
+        git_repository_free(repo);
+
+        return name;
+    }
+};
+
+int main()
+{
+    // Enough workers to decode long walks in parallel, even on a single core.
+    TaskScheduler::setDefaultWorkerCount(4);
+
+    "OidIndex"_test = [] {
+        it("should extend abbreviations past a shared prefix") = [] {
+            // 0xabcdef0123 and 0xabcdef0124 share their first 9 hex digits.
+            const unsigned char a[20] = { 0xab, 0xcd, 0xef, 0x01, 0x23 };
+            const unsigned char b[20] = { 0xab, 0xcd, 0xef, 0x01, 0x24 };
+            const unsigned char c[20] = { 0x12, 0x34 };
+
+            OidIndex index;
+            index.insert(a);
+            index.insert(b);
+            index.insert(c);
+            index.insert(c);
+            index.sort();
+
+            expect(that % index.size() == static_cast<size_t>(3)) << "duplicates are removed";
+            expect(that % index.abbrevLength(a) == 10);
+            expect(that % index.abbrevLength(b) == 10);
+            expect(that % index.abbrevLength(c) == 7) << "never shorter than the default";
+        };
+    };
+
+    "BloomFilter"_test = [] {
+        it("should contain every changed path") = [] {
+            std::vector<std::string> paths { "packages", "packages/core", "packages/core/a.js" };
+            for (int i = 0; i < 100; i++) {
+                paths.push_back("src/file" + std::to_string(i) + ".cpp");
+            }
+
+            const auto filter = BloomFilter::fromPaths(paths);
+            for (const auto &path : paths) {
+                expect(filter.contains(path)) << path;
+            }
+        };
+
+        it("should rule out most unchanged paths") = [] {
+            const auto filter = BloomFilter::fromPaths({ "docs", "docs/index.md" });
+            int falsePositives = 0;
+            for (int i = 0; i < 1000; i++) {
+                falsePositives += filter.contains("packages/p" + std::to_string(i)) ? 1 : 0;
+            }
+            expect(that % falsePositives < 100);
+        };
+
+        it("should match everything for large commits") = [] {
+            std::vector<std::string> paths(BloomFilter::MaxChangedPaths + 1, "x");
+            expect(BloomFilter::fromPaths(paths).contains("anything"));
+        };
+    };
+
+    "Caches"_test = [] {
+        const auto dir = std::filesystem::temp_directory_path() / "standard-release-caches";
+        std::filesystem::remove_all(dir);
+
+        // Header of a cache file, then `tail`.
+        const auto writeCache = [](const std::filesystem::path &fileName, const char *magic,
+                                   uint32_t count, const std::string &tail) {
+            const uint32_t version = 1;
+            std::ofstream out(fileName, std::ios::binary);
+            out.write(magic, 4);
+            out.write(reinterpret_cast<const char *>(&version), sizeof(version));
+            out.write(reinterpret_cast<const char *>(&count), sizeof(count));
+            out << tail;
+        };
+
+        it("should read back saved patch IDs and filters") = [dir] {
+            const unsigned char id[20] = { 0x12, 0x34 };
+            const unsigned char patchId[20] = { 0x56, 0x78 };
+
+            PatchIdCache patchIds;
+            expect(patchIds.load(dir / "patch-ids")) << "missing file is an empty cache";
+            patchIds.insert(id, patchId);
+            expect(patchIds.save());
+
+            PatchIdCache loadedIds;
+            expect(loadedIds.load(dir / "patch-ids"));
+            const unsigned char *found = loadedIds.find(id);
+            expect(found != nullptr && std::memcmp(found, patchId, sizeof(patchId)) == 0);
+
+            ChangedPathIndex index;
+            expect(index.load(dir / "changed-paths"));
+            index.insert(id, BloomFilter::fromPaths({ "src", "src/a.cpp" }));
+            expect(index.save());
+
+            ChangedPathIndex loadedIndex;
+            expect(loadedIndex.load(dir / "changed-paths"));
+            expect(loadedIndex.find(id) != nullptr && loadedIndex.find(id)->contains("src/a.cpp"));
+            expect(!std::filesystem::exists(dir / "changed-paths.lock"));
+        };
+
+        it("should reject counts and lengths larger than the file") = [dir, writeCache] {
+            writeCache(dir / "patch-ids", "SRPI", 0xffffffff, std::string(40, 'x'));
+            PatchIdCache patchIds;
+            expect(!patchIds.load(dir / "patch-ids"));
+            expect(that % patchIds.size() == static_cast<size_t>(0));
+
+            const uint32_t length = 0xffffffff;
+            writeCache(dir / "changed-paths", "SRBF", 1,
+                       std::string(20, 'x')
+                               + std::string(reinterpret_cast<const char *>(&length), 4));
+            ChangedPathIndex index;
+            expect(!index.load(dir / "changed-paths"));
+            expect(that % index.size() == static_cast<size_t>(0));
+        };
+
+        it("should let only one of two concurrent writers save") = [dir] {
+            const uint32_t first = 1;
+            const uint32_t second = 2;
+
+            {
+                CacheFileWriter writer(dir / "cache");
+                CacheFileWriter other(dir / "cache");
+                expect(writer.isOpen());
+                expect(!other.isOpen()) << "the lock file is taken";
+                other.write(&second, sizeof(second));
+                expect(!other.commit());
+
+                writer.writeHeader({ 'T', 'E', 'S', 'T' }, 1, 1);
+                writer.write(&first, sizeof(first));
+                expect(writer.commit());
+            }
+
+            CacheFileReader reader(dir / "cache");
+            uint32_t count = 0;
+            uint32_t value = 0;
+            expect(reader.readHeader({ 'T', 'E', 'S', 'T' }, 1, sizeof(value), count));
+            expect(reader.read(&value, sizeof(value)));
+            expect(that % value == first);
+            expect(!std::filesystem::exists(dir / "cache.lock"));
+
+            {
+                CacheFileWriter writer(dir / "cache");
+                CacheFileWriter other(dir / "cache");
+                expect(!other.isOpen());
+            }
+            expect(!std::filesystem::exists(dir / "cache.lock"))
+                    << "an abandoned save removes its own lock";
+        };
+
+        std::filesystem::remove_all(dir);
+    };
+
+    "GitRepository"_test = [] {
+        it("should split a commit message into summary and body") = [] {
+            const auto commit = GitRepository::Commit::fromMessage(
+                    "feat: add a walk mode\n\nRefs #7\n\nBREAKING CHANGE: gone\n\n");
+            expect(that % commit.summary() == std::string_view("feat: add a walk mode"));
+            expect(that % commit.body() == std::string_view("Refs #7\n\nBREAKING CHANGE: gone"));
+
+            const auto wrapped = GitRepository::Commit::fromMessage("fix: handle\n  commas\n");
+            expect(that % wrapped.summary() == std::string_view("fix: handle commas"));
+            expect(wrapped.body().empty());
+
+            const GitRepository::Commit split("fix: a", "body");
+            expect(that % split.message() == std::string("fix: a\n\nbody"));
+            expect(that % split.body() == std::string_view("body"));
+        };
+
+        it("should abbreviate commit hashes uniquely") = [] {
+            TestRepos repos("abbrev");
+            repos.commitFile("a.txt", "a\n", "feat: add a");
+            repos.commitFile("b.txt", "b\n", "fix: add b");
+
+            GitRepository repo;
+            expect(repo.open(repos.work)) << "opened the working repository";
+            repo.parse("0.0.0");
+
+            const auto commits = repo.commits();
+            expect(that % commits.size() == static_cast<size_t>(2));
+            for (const auto &commit : commits) {
+                expect(that % commit.hash.length() >= static_cast<size_t>(7));
+                expect(that % commit.id.find(commit.hash) == static_cast<size_t>(0))
+                        << "the hash abbreviates the full ID";
+            }
+        };
+
+        it("should push a branch and a tag in a single push") = [] {
+            TestRepos repos("push");
+            repos.commitFile("VERSION.txt", "1.0.0\n", "feat: initial commit");
+
+            GitRepository repo;
+            expect(repo.open(repos.work)) << "opened the working repository";
+            expect(repo.createTag("v1.0.0", "chore(release): 1.0.0")) << "created the tag";
+
+            const auto branch = repos.headName();
+            const bool pushed = repo.push({ branch, "refs/tags/v1.0.0" });
+            expect(pushed) << repo.error().message();
+            expect(!repo.error()) << "a branch without an upstream is not an error";
+
+            const auto stats = repo.pushStats();
+            expect(that % stats.refs == static_cast<size_t>(2)) << "both refspecs were sent";
+            expect(repos.remoteHasRef(branch)) << "the branch reached the remote";
+            expect(repos.remoteHasRef("refs/tags/v1.0.0")) << "the tag reached the remote";
+
+            std::cout << "push: negotiation " << stats.negotiationMs << " ms, total "
+                      << stats.totalMs << " ms, " << stats.objects << " objects ("
+                      << stats.bytes << " bytes)" << std::endl;
+        };
+
+        it("should skip the commits inside merged branches in first-parent mode") = [] {
+            TestRepos repos("walk-modes");
+            repos.commitFile("a.txt", "a\n", "feat: add a");
+            const auto base = repos.headId();
+            repos.commitFile("b.txt", "b\n", "fix: side b");
+            repos.commitFile("c.txt", "c\n", "fix: side c");
+            const auto side = repos.headId();
+            const auto main = repos.commitWithParents({ base }, "feat: main d");
+            repos.commitWithParents({ main, side }, "Merge branch 'side'");
+
+            const auto summaries = [&repos](GitRepository::WalkMode mode) {
+                GitRepository repo;
+                expect(repo.open(repos.work)) << "opened the working repository";
+                repo.setWalkMode(mode);
+                repo.parse("0.0.0");
+
+                std::vector<std::string> result;
+                for (const auto &commit : repo.commits()) {
+                    result.emplace_back(commit.summary());
+                }
+                return result;
+            };
+
+            const std::vector<std::string> firstParent = summaries(GitRepository::FirstParent);
+            expect(firstParent
+                   == std::vector<std::string> { "Merge branch 'side'", "feat: main d",
+                                                 "feat: add a" });
+
+            for (const auto mode : { GitRepository::Default, GitRepository::Topological,
+                                     GitRepository::Time }) {
+                const auto all = summaries(mode);
+                expect(that % all.size() == static_cast<size_t>(5)) << "walk mode" << mode;
+                expect(std::count(all.begin(), all.end(), "fix: side b") == 1);
+                expect(std::count(all.begin(), all.end(), "fix: side c") == 1);
+                expect(that % all.front() == std::string("Merge branch 'side'"));
+            }
+            const auto topological = summaries(GitRepository::Topological);
+            expect(that % topological.back() == std::string("feat: add a"))
+                    << "parents follow all of their children";
+        };
+
+        it("should only return commits that touched a path") = [] {
+            TestRepos repos("paths");
+            repos.commitFile("README.md", "readme\n", "docs: add readme");
+            repos.commitFile("packages/core/index.js", "1\n", "feat(core): add core");
+            repos.commitFile("packages/cli/index.js", "1\n", "feat(cli): add cli");
+            repos.commitFile("packages/core/util.js", "1\n", "fix(core): add util");
+            repos.commitFile("README.md", "readme 2\n", "docs: update readme");
+
+            GitRepository repo;
+            expect(repo.open(repos.work)) << "opened the working repository";
+            repo.setPathFilter("./packages/core/");
+            expect(that % repo.pathFilter() == std::string("packages/core"));
+            repo.parse("0.0.0");
+
+            const auto commits = repo.commits();
+            expect(that % commits.size() == static_cast<size_t>(2));
+            for (const auto &commit : commits) {
+                expect(that % commit.summary().find("(core)") != std::string::npos)
+                        << commit.summary() << " touched packages/core";
+            }
+        };
+
+        it("should return the same commits with the changed-path index") = [] {
+            TestRepos repos("pathindex");
+            repos.commitFile("README.md", "readme\n", "docs: add readme");
+            repos.commitFile("packages/core/index.js", "1\n", "feat(core): add core");
+            repos.commitFile("packages/cli/index.js", "1\n", "feat(cli): add cli");
+            repos.commitFile("packages/core/util.js", "1\n", "fix(core): add util");
+
+            for (int run = 0; run < 2; run++) {
+                GitRepository repo;
+                repo.open(repos.work);
+                repo.setPathFilter("packages/core");
+                repo.setPathIndex(true);
+                repo.parse("0.0.0");
+
+                expect(that % repo.commits().size() == static_cast<size_t>(2))
+                        << (run == 0 ? "while building the index" : "with the saved index");
+            }
+
+            const auto indexFile = repos.work / ".git/standard-release/changed-paths";
+            expect(std::filesystem::exists(indexFile)) << "the index was saved";
+        };
+
+        it("should give a repeated change the same patch ID") = [] {
+            TestRepos repos("patchid");
+            repos.commitFile("a.txt", "1\n", "docs: add a");
+            repos.commitFile("a.txt", "2\n", "fix: handle commas");
+            repos.commitFile("a.txt", "1\n", "chore: reset a");
+            repos.commitFile("a.txt", "2\n", "fix: handle commas (backport)");
+
+            for (int run = 0; run < 2; run++) {
+                GitRepository repo;
+                repo.open(repos.work);
+                repo.setDetectDuplicates(true);
+                repo.parse("0.0.0");
+
+                std::map<std::string, std::string> patchIds;
+                for (const auto &commit : repo.commits()) {
+                    patchIds[std::string(commit.summary())] = commit.patchId;
+                }
+
+                const auto when = run == 0 ? "while diffing" : "from the cache";
+                expect(that % patchIds.size() == static_cast<size_t>(4));
+                expect(!patchIds["fix: handle commas"].empty()) << when;
+                expect(that % patchIds["fix: handle commas (backport)"]
+                       == patchIds["fix: handle commas"])
+                        << when;
+                expect(that % patchIds["chore: reset a"] != patchIds["fix: handle commas"]);
+            }
+
+            const auto cacheFile = repos.work / ".git/standard-release/patch-ids";
+            expect(std::filesystem::exists(cacheFile)) << "the cache was saved";
+        };
+
+        it("should decode long walks in parallel in walk order") = [] {
+            TestRepos repos("decode");
+            const int count = 1200;
+            for (int i = 0; i < count; i++) {
+                const std::string dir = i % 2 == 0 ? "a" : "b";
+                repos.commitFile(dir + "/file.txt", std::to_string(i) + "\n",
+                                 "fix: change " + std::to_string(i));
+            }
+
+            GitRepository all;
+            all.open(repos.work);
+            all.parse("0.0.0");
+            expect(that % all.commits().size() == static_cast<size_t>(count));
+
+            int expected = count - 1;
+            for (const auto &commit : all.commits()) {
+                if (commit.summary() != "fix: change " + std::to_string(expected)) {
+                    expect(false) << commit.summary() << " out of order";
+                    break;
+                }
+                expected--;
+            }
+
+            for (int run = 0; run < 2; run++) {
+                GitRepository filtered;
+                filtered.open(repos.work);
+                filtered.setPathFilter("a");
+                filtered.setPathIndex(true);
+                filtered.parse("0.0.0");
+
+                const auto commits = filtered.commits();
+                expect(that % commits.size() == static_cast<size_t>(count / 2))
+                        << (run == 0 ? "while building the index" : "with the saved index");
+                expect(that % commits.front().summary()
+                       == "fix: change " + std::to_string(count - 2));
+                expect(that % commits.back().summary() == std::string_view("fix: change 0"));
+            }
+        };
+
+        it("should read only the commits added since the last parse") = [] {
+            TestRepos repos("update");
+            repos.commitFile("a.txt", "1\n", "feat: add a");
+
+            GitRepository repo;
+            repo.open(repos.work);
+            repo.parse("0.0.0");
+            const auto oldHead = repo.headId();
+            expect(that % repo.commits().size() == static_cast<size_t>(1));
+
+            GitRepository::Commits added;
+            expect(repo.update(added)) << "HEAD did not move";
+            expect(that % added.size() == static_cast<size_t>(0));
+
+            repos.commitFile("a.txt", "2\n", "fix: change a");
+            repos.commitFile("b.txt", "1\n", "feat: add b");
+            expect(repo.update(added)) << repo.error().message();
+            expect(that % added.size() == static_cast<size_t>(2));
+            expect(that % added.front().summary() == std::string_view("feat: add b"))
+                    << "newest first";
+            expect(that % repo.commits().size() == static_cast<size_t>(3));
+            expect(that % repo.commits().back().summary() == std::string_view("feat: add a"));
+            expect(that % repo.headId() != oldHead);
+            expect(that % repo.headId() == repo.commits().front().id);
+        };
+
+        it("should write a multi-tag release as one packfile") = [] {
+            TestRepos repos("batch");
+            repos.commitFile("VERSION.txt", "1.0.0\n", "feat: initial commit");
+
+            std::ofstream out(repos.work / "VERSION.txt");
+            out << "2.0.0\n";
+            out.close();
+
+            GitRepository repo;
+            expect(repo.open(repos.work)) << "opened the working repository";
+
+            const std::vector<std::string> tags { "core-v2.0.0", "cli-v2.0.0", "docs-v2.0.0" };
+            const bool released = repo.createRelease("chore(release): 2.0.0", tags);
+            expect(released) << repo.error().message();
+
+            git_repository *raw = nullptr;
+            git_repository_open(&raw, repos.work.string().c_str());
+            for (const auto &tag : tags) {
+                git_object *obj = nullptr;
+                const std::string spec = tag + "^{commit}";
+                const int ret = git_revparse_single(&obj, raw, spec.c_str());
+                expect(that % ret == GIT_OK) << tag << " exists";
+                git_object_free(obj);
+            }
+            git_repository_free(raw);
+
+            expect(that % repos.packCount() == static_cast<size_t>(1))
+                    << "the commit, tree and tags were written as a single pack";
+        };
+
+        it("should stay usable after a failed release") = [] {
+            TestRepos repos("failed-release");
+            repos.commitFile("VERSION.txt", "1.0.0\n", "feat: initial commit");
+            repos.setIdentity("");
+
+            GitRepository repo;
+            expect(repo.open(repos.work)) << "opened the working repository";
+            const auto oldHead = repo.currentHeadId();
+            expect(throws([&repo] { repo.createRelease("1.0.0"); })) << "no identity";
+            expect(repo.error() == Error::GitBadSignature) << repo.error().message();
+            expect(that % repo.currentHeadId() == oldHead);
+
+            repos.setIdentity("Standard Release");
+            expect(repo.createRelease("1.0.0")) << repo.error().message();
+            expect(that % repo.currentHeadId() != oldHead);
+
+            git_repository *raw = nullptr;
+            git_object *tag = nullptr;
+            git_repository_open(&raw, repos.work.string().c_str());
+            expect(that % git_revparse_single(&tag, raw, "v1.0.0^{commit}") == GIT_OK);
+            git_object_free(tag);
+            git_repository_free(raw);
+        };
+    };
+}
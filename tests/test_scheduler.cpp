@@ -0,0 +1,204 @@
+#include "boost/ut.hpp"
+#include "standard-release/tasks/graph.h"
+#include "standard-release/tasks/scheduler.h"
+#include <atomic>
+#include <chrono>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace boost::ut;
+using namespace boost::ut::spec;
+using namespace StandardRelease;
+
+int main()
+{
+    "TaskScheduler"_test = [] {
+        it("should start the requested number of workers") = [] {
+            TaskScheduler scheduler(3);
+            expect(that % scheduler.workerCount() == static_cast<size_t>(3));
+            expect(that % scheduler.currentWorker() == -1) << "the test thread is not a worker";
+        };
+
+        it("should run every task exactly once") = [] {
+            const int count = 100000;
+            TaskScheduler scheduler(4);
+            std::vector<std::atomic<int>> runs(count);
+            TaskGroup group(scheduler);
+
+            for (int i = 0; i < count; i++) {
+                group.run([&runs, i] { runs[i]++; });
+            }
+            group.wait();
+
+            int wrong = 0;
+            for (const auto &run : runs) {
+                wrong += run == 1 ? 0 : 1;
+            }
+            expect(that % wrong == 0);
+        };
+
+        it("should run tasks spawned by other tasks") = [] {
+            TaskScheduler scheduler(4);
+            std::atomic<int> leaves { 0 };
+            TaskGroup group(scheduler);
+
+            for (int i = 0; i < 64; i++) {
+                group.run([&scheduler, &leaves] {
+                    TaskGroup inner(scheduler);
+                    for (int j = 0; j < 64; j++) {
+                        inner.run([&leaves] { leaves++; });
+                    }
+                    inner.wait();
+                });
+            }
+            group.wait();
+
+            expect(that % leaves.load() == 64 * 64);
+        };
+
+        it("should not deadlock when every worker waits on a nested group") = [] {
+            TaskScheduler scheduler(1);
+            std::atomic<int> depth { 0 };
+
+            std::function<void(int)> recurse = [&](int level) {
+                depth = std::max(depth.load(), level);
+                if (level == 8) {
+                    return;
+                }
+                TaskGroup inner(scheduler);
+                inner.run([&recurse, level] { recurse(level + 1); });
+                inner.run([&recurse, level] { recurse(level + 1); });
+                inner.wait();
+            };
+
+            TaskGroup group(scheduler);
+            group.run([&recurse] { recurse(0); });
+            group.wait();
+
+            expect(that % depth.load() == 8);
+        };
+
+        it("should rethrow the first exception from wait()") = [] {
+            TaskScheduler scheduler(2);
+            TaskGroup group(scheduler);
+
+            group.run([] { throw std::runtime_error("boom"); });
+            expect(throws([&group] { group.wait(); }));
+            expect(group.isCancelled()) << "a failed task cancels the group";
+        };
+
+        it("should skip tasks that have not started when cancelled") = [] {
+            TaskScheduler scheduler(1);
+            std::atomic<bool> release { false };
+            std::atomic<int> ran { 0 };
+            TaskGroup group(scheduler);
+
+            // Keep the only worker busy so the other tasks are still queued.
+            group.run([&release] {
+                while (!release) {
+                    std::this_thread::yield();
+                }
+            });
+            for (int i = 0; i < 100; i++) {
+                group.run([&ran] { ran++; });
+            }
+
+            group.cancel();
+            release = true;
+            group.wait();
+
+            expect(that % ran.load() == 0);
+            expect(group.token().isCancelled());
+        };
+
+        it("should finish queued tasks before shutting down") = [] {
+            std::atomic<int> ran { 0 };
+            {
+                TaskScheduler scheduler(2);
+                for (int i = 0; i < 1000; i++) {
+                    scheduler.submit([&ran] { ran++; });
+                }
+            }
+            expect(that % ran.load() == 1000);
+        };
+
+        it("should cover a range exactly once with parallelFor") = [] {
+            TaskScheduler scheduler(4);
+            std::vector<int> items(10007, 0);
+
+            parallelFor(scheduler, items.size(), 64, [&items](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    items[i]++;
+                }
+            });
+
+            expect(that % std::accumulate(items.begin(), items.end(), 0) == 10007);
+        };
+    };
+
+    "TaskGraph"_test = [] {
+        it("should run tasks after their dependencies") = [] {
+            TaskScheduler scheduler(4);
+            TaskGraph graph(scheduler);
+            std::atomic<int> clock { 0 };
+            int order[4] = { -1, -1, -1, -1 };
+
+            const auto a = graph.add("a", [&] { order[0] = clock++; });
+            const auto b = graph.add("b", [&] { order[1] = clock++; }, { a });
+            const auto c = graph.add("c", [&] { order[2] = clock++; }, { a });
+            graph.add("d", [&] { order[3] = clock++; }, { b, c });
+
+            graph.run();
+
+            expect(that % graph.size() == static_cast<size_t>(4));
+            expect(that % graph.name(b) == std::string("b"));
+            expect(order[0] < order[1] && order[0] < order[2]) << "a runs first";
+            expect(order[3] > order[1] && order[3] > order[2]) << "d runs last";
+        };
+
+        it("should overlap independent tasks") = [] {
+            TaskScheduler scheduler(2);
+            TaskGraph graph(scheduler);
+            std::atomic<bool> first { false };
+            std::atomic<bool> second { false };
+            std::atomic<bool> overlapped { false };
+
+            // Each side waits (briefly) for the other to start.
+            const auto wait = [&overlapped](std::atomic<bool> &self, std::atomic<bool> &other) {
+                self = true;
+                const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+                while (!other && std::chrono::steady_clock::now() < deadline) {
+                    std::this_thread::yield();
+                }
+                if (other) {
+                    overlapped = true;
+                }
+            };
+
+            graph.add("first", [&] { wait(first, second); });
+            graph.add("second", [&] { wait(second, first); });
+            graph.run();
+
+            expect(overlapped.load());
+        };
+
+        it("should skip dependents of a failed task") = [] {
+            TaskScheduler scheduler(2);
+            TaskGraph graph(scheduler);
+            std::atomic<bool> ran { false };
+
+            const auto fail = graph.add("fail", [] { throw std::runtime_error("boom"); });
+            graph.add("after", [&ran] { ran = true; }, { fail });
+
+            expect(throws([&graph] { graph.run(); }));
+            expect(!ran.load());
+        };
+
+        it("should reject dependencies on later tasks") = [] {
+            TaskGraph graph;
+            expect(throws([&graph] { graph.add("bad", [] {}, { 3 }); }));
+        };
+    };
+}
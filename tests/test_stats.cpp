@@ -0,0 +1,68 @@
+#include "boost/ut.hpp"
+#include "standard-release/stats/stats.h"
+#include "standard-release/tasks/graph.h"
+#include "standard-release/tasks/scheduler.h"
+#include <string>
+
+using namespace boost::ut;
+using namespace boost::ut::spec;
+using namespace StandardRelease;
+
+int main()
+{
+    "Stats"_test = [] {
+        it("should reset counters when started") = [] {
+            Stats::add(Stats::CommitsWalked, 5);
+            Stats::start();
+            expect(Stats::isEnabled());
+            expect(that % Stats::value(Stats::CommitsWalked) == static_cast<uint64_t>(0));
+
+            Stats::add(Stats::CommitsWalked, 3);
+            Stats::add(Stats::BytesRead, 100);
+            expect(that % Stats::value(Stats::CommitsWalked) == static_cast<uint64_t>(3));
+            expect(that % Stats::value(Stats::BytesRead) == static_cast<uint64_t>(100));
+        };
+
+        it("should time every graph task") = [] {
+            Stats::start();
+
+            TaskScheduler scheduler(2);
+            TaskGraph graph(scheduler);
+            const auto a = graph.add("open", [] {});
+            graph.add("history", [] {
+                volatile double sink = 0;
+                for (int i = 0; i < 1000000; i++) {
+                    sink = sink + i;
+                }
+            }, { a });
+            graph.run();
+
+            const auto phases = Stats::phases();
+            expect(that % phases.size() == static_cast<size_t>(2));
+            expect(that % phases.back().name == std::string("history"));
+            expect(that % phases.back().cpuMs > 0.0) << "CPU time is measured";
+            expect(that % phases.back().wallMs >= 0.0);
+        };
+
+        it("should report counters, phases and peak RSS") = [] {
+            Stats::start();
+            Stats::add(Stats::CommitsDecoded, 42);
+            Stats::recordPhase("changelog-write", 1.5, 1.0);
+
+            const auto json = Stats::json();
+            expect(that % json.find("\"commits_decoded\": {\"total\": 42") != std::string::npos)
+                    << json;
+            expect(that % json.find("\"name\": \"changelog-write\"") != std::string::npos);
+
+            Stats::recordPhase("release \"v1\"", 0.5, 0.5);
+            expect(that % Stats::json().find("\"name\": \"release \\\"v1\\\"\"")
+                   != std::string::npos)
+                    << "phase names are escaped";
+            expect(that % Stats::peakRss() > static_cast<uint64_t>(0));
+
+            const auto text = Stats::report();
+            expect(that % text.find("commits_decoded") != std::string::npos) << text;
+            expect(that % text.find("peak_rss") != std::string::npos);
+        };
+    };
+}
@@ -0,0 +1,73 @@
+#include "boost/ut.hpp"
+#include "standard-release/tasks/graph.h"
+#include "standard-release/tasks/scheduler.h"
+#include "standard-release/trace/trace.h"
+#include <string>
+#include <thread>
+
+using namespace boost::ut;
+using namespace boost::ut::spec;
+using namespace StandardRelease;
+
+static size_t occurrences(const std::string &text, const std::string &needle)
+{
+    size_t count = 0;
+    for (size_t pos = text.find(needle); pos != std::string::npos;
+         pos = text.find(needle, pos + 1)) {
+        count++;
+    }
+    return count;
+}
+
+int main()
+{
+    "Tracer"_test = [] {
+        it("should record nothing while disabled") = [] {
+            Tracer tracer;
+            tracer.record("span", "test", 0, 10);
+            expect(that % tracer.size() == static_cast<size_t>(0));
+        };
+
+        it("should write complete events with thread ids") = [] {
+            Tracer tracer;
+            tracer.start();
+            tracer.setThreadName("main");
+            tracer.record("first", "test", 100, 150);
+
+            std::thread other([&tracer] { tracer.record("second", "test", 120, 200, "a \"b\""); });
+            other.join();
+
+            const auto json = tracer.json();
+            expect(that % tracer.size() == static_cast<size_t>(2));
+            expect(that % json.find("\"name\":\"first\",\"cat\":\"test\",\"ph\":\"X\",\"ts\":100,"
+                                    "\"dur\":50")
+                   != std::string::npos)
+                    << json;
+            expect(that % json.find("\"tid\":1") != std::string::npos);
+            expect(that % json.find("\"tid\":2") != std::string::npos);
+            expect(that % json.find("\"args\":{\"detail\":\"a \\\"b\\\"\"}") != std::string::npos)
+                    << "details are escaped";
+            expect(that % json.find("\"thread_name\"") != std::string::npos);
+        };
+
+        it("should record a span for every graph task") = [] {
+            Tracer &tracer = Tracer::global();
+            tracer.clear();
+            tracer.start();
+
+            {
+                TaskScheduler scheduler(2);
+                TaskGraph graph(scheduler);
+                const auto a = graph.add("load", [] {});
+                graph.add("generate", [] { TraceSpan span("inner", "test"); }, { a });
+                graph.run();
+            }
+
+            tracer.stop();
+            const auto json = tracer.json();
+            expect(that % occurrences(json, "\"cat\":\"task\"") == static_cast<size_t>(2));
+            expect(that % json.find("\"name\":\"inner\"") != std::string::npos);
+            expect(that % json.find("\"name\":\"worker 0\"") != std::string::npos);
+        };
+    };
+}